@@ -36,13 +36,20 @@ SOURCES += \
     src/network/cw_protocol.cpp \
     src/network/cw_server.cpp \
     src/network/cw_socket.cpp \
+    src/autoplay.cpp \
     src/board.cpp \
+    src/cellbitset.cpp \
+    src/cellstore.cpp \
     src/console.cpp \
+    src/distancefield.cpp \
     src/game.cpp \
     src/honeycomb.cpp \
     src/main.cpp \
     src/mainwindow.cpp \
-    src/nation.cpp
+    src/nation.cpp \
+    src/simulator.cpp \
+    src/territory.cpp \
+    src/workerpool.cpp
 
 HEADERS += \
     include/network/cw_client.h \
@@ -51,13 +58,25 @@ HEADERS += \
     include/network/cw_server.h \
     include/network/cw_socket.h \
     include/network/network.h \
+    include/arena.h \
+    include/autoplay.h \
     include/board.h \
+    include/cellbitset.h \
+    include/cellstore.h \
     include/console.h \
+    include/distancefield.h \
     include/game.h \
     include/globals.h \
+    include/hexgeometry.h \
+    include/hexring.h \
     include/honeycomb.h \
     include/mainwindow.h \
-    include/nation.h
+    include/nation.h \
+    include/palette.h \
+    include/simulator.h \
+    include/span.h \
+    include/territory.h \
+    include/workerpool.h
 
 # Specify Build settings.
 unix {
@@ -0,0 +1,143 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "include/globals.h"
+
+/*!
+ * \brief The CArena class
+ *
+ * This class is a simple typed arena. Objects are constructed in place inside large blocks and are never freed one at a time, instead the whole arena is reset
+ * in one go. A reset keeps the blocks around so the next batch of objects (e.g. the next game's board) doesn't touch the heap at all, and objects that don't need
+ * destructing are dropped without visiting them.
+ *
+ * \note Pointers handed out by the arena stay valid until the next Reset or Release.
+ */
+template <typename T>
+class CArena
+{
+public:
+    explicit CArena(size_t uBlockSize = 1024) : muBlockSize{(0 < uBlockSize) ? uBlockSize : 1}, muCurBlock{0}
+    {
+        // Intentionally left blank.
+    }
+
+    CArena(const CArena& aCls) = delete;
+    CArena& operator=(const CArena& aCls) = delete;
+
+    ~CArena()
+    {
+        Release();
+    }
+
+    /*!
+     * \brief CArena::Alloc
+     *
+     * Constructs a new object in the arena.
+     *
+     * \param args - Arguments forwarded to the object's constructor.
+     * \return Pointer to the new object.
+     */
+    template <typename... Args>
+    T* Alloc(Args&&... args)
+    {
+        while (mvBlocks.size() > muCurBlock && mvBlocks[muCurBlock].uUsed == mvBlocks[muCurBlock].uSize) { ++muCurBlock; }
+        if (mvBlocks.size() == muCurBlock) { AddBlock(muBlockSize); }
+
+        SBlock& lBlock = mvBlocks[muCurBlock];
+        T* pObj = new (lBlock.pData + lBlock.uUsed) T(std::forward<Args>(args)...);
+        ++lBlock.uUsed;
+
+        return pObj;
+    }
+
+    /*!
+     * \brief CArena::Reserve
+     *
+     * Makes sure at least "uCount" objects fit in the arena without allocating again. Any missing room is added as a single block.
+     *
+     * \param uCount - Total number of objects the arena should hold.
+     */
+    void Reserve(size_t uCount)
+    {
+        const size_t c_uCapacity = GetCapacity();
+        if (c_uCapacity < uCount) { AddBlock(uCount - c_uCapacity); }
+    }
+
+    /*!
+     * \brief CArena::Reset
+     *
+     * Drops every object in the arena but keeps the memory for reuse.
+     */
+    void Reset()
+    {
+        for (typename std::vector<SBlock>::iterator pBlockIter = mvBlocks.begin(); pBlockIter != mvBlocks.end(); ++pBlockIter)
+        {
+            if (!std::is_trivially_destructible<T>::value)
+            {
+                for (size_t uIdx = 0; pBlockIter->uUsed > uIdx; ++uIdx) { pBlockIter->pData[uIdx].~T(); }
+            }
+
+            pBlockIter->uUsed = 0;
+        }
+
+        muCurBlock = 0;
+    }
+
+    /*!
+     * \brief CArena::Release
+     *
+     * Drops every object in the arena and hands the memory back.
+     */
+    void Release()
+    {
+        Reset();
+
+        for (typename std::vector<SBlock>::iterator pBlockIter = mvBlocks.begin(); pBlockIter != mvBlocks.end(); ++pBlockIter)
+        {
+            ::operator delete(pBlockIter->pData);
+        }
+
+        mvBlocks.clear();
+    }
+
+    // Getters.
+    size_t GetCount()
+    {
+        size_t uCount = 0;
+        for (typename std::vector<SBlock>::iterator pBlockIter = mvBlocks.begin(); pBlockIter != mvBlocks.end(); ++pBlockIter) { uCount += pBlockIter->uUsed; }
+
+        return uCount;
+    }
+
+    size_t GetCapacity()
+    {
+        size_t uCapacity = 0;
+        for (typename std::vector<SBlock>::iterator pBlockIter = mvBlocks.begin(); pBlockIter != mvBlocks.end(); ++pBlockIter) { uCapacity += pBlockIter->uSize; }
+
+        return uCapacity;
+    }
+
+private:
+    //! A single chunk of raw storage, objects are constructed in it from the front.
+    struct SBlock
+    {
+        T* pData; //!< Raw storage for "uSize" objects.
+        size_t uSize; //!< Number of objects the block holds.
+        size_t uUsed; //!< Number of objects constructed in the block.
+    };
+
+    void AddBlock(size_t uSize)
+    {
+        SBlock lBlock;
+        lBlock.pData = static_cast<T*>(::operator new(sizeof(T) * uSize));
+        lBlock.uSize = uSize;
+        lBlock.uUsed = 0;
+        mvBlocks.push_back(lBlock);
+    }
+
+    std::vector<SBlock> mvBlocks; //!< Storage blocks, in allocation order.
+    size_t muBlockSize; //!< Size (in objects) of blocks added on demand.
+    size_t muCurBlock; //!< Block the next object is constructed in.
+};
+
+#endif // ARENA_H
@@ -0,0 +1,98 @@
+#ifndef AUTOPLAY_H
+#define AUTOPLAY_H
+
+#include <chrono>
+#include "include/game.h"
+
+#if !defined(_AUTO_PLAY)
+#define _AUTO_PLAY
+#define AUTO_DEFAULT_RATE (30) //!< Moves per second auto-play makes unless it's told otherwise.
+#define AUTO_MAX_RATE (10000) //!< Most moves per second auto-play can be asked to make.
+#define AUTO_FRAME_MS (200) //!< Least milliseconds between auto-play redraws and client updates, however many moves are made in between.
+#define AUTO_MAX_BACKLOG_MS (100) //!< Milliseconds' worth of moves auto-play may fall behind by, anything more is dropped instead of caught up on.
+#define AUTO_BORDER_SAMPLES (16) //!< Frontier cells the "border" policy looks at per neighbor when working out which one leads towards it's prey.
+#endif // #if !defined(_AUTO_PLAY)
+
+/*!
+ * \brief The CMovePolicy class
+ *
+ * This class is the interface for anything that picks moves on it's own (auto-play, the simulator). A policy only picks who attacks who, the move itself is rolled
+ * and made by the caller with the game's rules. Policies are made by name with "Create".
+ */
+class CMovePolicy
+{
+public:
+    virtual ~CMovePolicy();
+
+    virtual const char* GetName() = 0;
+    virtual bool PickMove(CBoard& aBoard, CDice& aDice, ECellColors& eAggressor, ECellColors& eVictim) = 0;
+
+    static CMovePolicy* Create(const std::string& sName);
+};
+
+/*!
+ * \brief The CRandomPolicy class
+ *
+ * This policy ("random") picks moves the way players can make them with "!move": a random live color attacks White while White is still around, and a random
+ * other live color once it's gone. Colors that don't border each other are picked too, just like players do.
+ */
+class CRandomPolicy : public CMovePolicy
+{
+public:
+    const char* GetName() override;
+    bool PickMove(CBoard& aBoard, CDice& aDice, ECellColors& eAggressor, ECellColors& eVictim) override;
+};
+
+/*!
+ * \brief The CBorderPolicy class
+ *
+ * This policy ("border") only picks moves that can take cells: a random live color attacks a color it borders, White first while it borders White. After that
+ * every color hunts the smallest other color: it attacks it if they border, otherwise it pushes through whichever neighbor is closest to it (see CDistanceFields).
+ * No rolls are spent on colors that can't reach each other, so games move along faster to watch.
+ */
+class CBorderPolicy : public CMovePolicy
+{
+public:
+    const char* GetName() override;
+    bool PickMove(CBoard& aBoard, CDice& aDice, ECellColors& eAggressor, ECellColors& eVictim) override;
+};
+
+/*!
+ * \brief The CAutoPlayer class
+ *
+ * This class schedules auto-play: it hands out how many moves are due to keep to a rate (from a few to thousands a second) and when the next frame is due. The game
+ * makes the due moves quietly on each tick and only redraws and updates the clients once per frame (AUTO_FRAME_MS), so the output rate stays bounded however fast
+ * the moves are made. When moves can't keep up with the rate the backlog is dropped, the game runs as fast as it can instead of stalling the event loop.
+ */
+class CAutoPlayer
+{
+public:
+    CAutoPlayer();
+    ~CAutoPlayer();
+
+    // Workers.
+    void Start(u32 uMovesPerSec, CMovePolicy* pPolicy);
+    void Stop();
+
+    u32 TakeDueMoves();
+    bool TakeFrame();
+    bool PickMove(CBoard& aBoard, CDice& aDice, ECellColors& eAggressor, ECellColors& eVictim);
+
+    // Getters.
+    bool IsRunning();
+    u32 GetRate();
+    u64 GetNumMoves();
+    const char* GetPolicyName();
+
+private:
+    CMovePolicy* mpPolicy; //!< Policy picking the moves (owned).
+    u32 muMovesPerSec; //!< Moves to make per second.
+    u64 muMovesDue; //!< Moves handed out since the rate's start time.
+    u64 muNumMoves; //!< Moves handed out since auto-play started.
+    bool mbRunning; //!< Is auto-play running?
+    bool mbDirty; //!< Have moves been handed out since the last frame?
+    std::chrono::steady_clock::time_point mtStart; //!< Time the rate is counted from.
+    std::chrono::steady_clock::time_point mtLastFrame; //!< Time of the last frame.
+};
+
+#endif // AUTOPLAY_H
@@ -1,33 +1,90 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include "include/arena.h"
+#include "include/distancefield.h"
+#include "include/hexring.h"
 #include "include/nation.h"
+#include "include/territory.h"
+
+class CWorkerPool;
 
 typedef std::vector<CHoneyComb*>::iterator CombIterator; //!< This is used as a helper type for ease of iterating over the board combs.
 
+#if !defined(_BOARD_TEMPLATE)
+#define _BOARD_TEMPLATE
+#define BOARD_TEMPLATE_MAGIC (0x42435743) //!< "CWCB" (ColorWars Cached Board), the first 4 bytes of every board template.
+#define BOARD_TEMPLATE_VERSION (4) //!< Bump this whenever the template layout or the board generation changes.
+#define BOARD_TEMPLATE_ALIGN (16) //!< The tile-presence table is padded out to a multiple of this, so the tile arrays after it stay aligned for their floats.
+#endif // #if !defined(_BOARD_TEMPLATE)
+
+#if !defined(INFECTION_WORDS_PER_THREAD)
+#define INFECTION_WORDS_PER_THREAD (4096) //!< Fewest contested-set words (64 cells each) worth giving a thread of their own in InfectionStep.
+#endif // #if !defined(INFECTION_WORDS_PER_THREAD)
+
+/*!
+ * \brief The SBoardTemplateHeader struct
+ *
+ * This is the header of an on-disk board template. It's followed by (in order): uNumCombs SBoardTemplateComb records, one byte per cell store tile saying if the
+ * tile is stored (zero-padded to a multiple of BOARD_TEMPLATE_ALIGN bytes), and then each stored tile's center X, center Y, color (palette index) and validity arrays (CELL_TILE_SZ entries each). Everything is in native byte order,
+ * templates are a local cache and are simply regenerated if they don't match.
+ */
+struct SBoardTemplateHeader
+{
+    u32 uMagic; //!< Always BOARD_TEMPLATE_MAGIC.
+    u32 uVersion; //!< BOARD_TEMPLATE_VERSION of the writer.
+    u32 uCellSz; //!< Cell size the board was generated with.
+    u32 uBoardSize; //!< Number of layers the board was generated with.
+    float nCenterX; //!< Pixel center X the board was generated with.
+    float nCenterY; //!< Pixel center Y the board was generated with.
+    s32 iMinQ; //!< Smallest axial Q of the cell store's bounding box.
+    s32 iMinR; //!< Smallest axial R of the cell store's bounding box.
+    u32 uSpanQ; //!< Number of columns in the cell store's bounding box.
+    u32 uSpanR; //!< Number of rows in the cell store's bounding box.
+    u32 uNumCombs; //!< Number of honeycombs.
+    u32 uNumTiles; //!< Number of tiles in the cell store (stored or not).
+};
+
+//! A single honeycomb inside a board template.
+struct SBoardTemplateComb
+{
+    s32 iQ; //!< Axial Q of the comb's center cell.
+    s32 iR; //!< Axial R of the comb's center cell.
+    u32 uColor; //!< Starting color of the comb.
+};
+
 /*!
  * \brief The CBoard class
  *
  * This class is designed to tessellate the honeycombs into a playing board for the game to use. This should be done only once during the "Create" method and when the board is finished,
  * it should be destroyed using the "Destroy" method. This class should also provide a seamless way of getting neighbor combs for a given honeycomb. This will enable quick searching and
  * minimize tick time.
+ *
+ * Boards can't be copied, their combs, nations and cell views all point into the board's own arenas and cell store. To get a board's cells elsewhere take a
+ * snapshot (see GetSnapshot) and load it onto another board of the same layout (see LoadColors).
  */
 class CBoard
 {
 public:
     CBoard();
-    CBoard(const CBoard& aCls);
+    CBoard(const CBoard& aCls) = delete;
     ~CBoard();
 
     // Overloads.
-    CBoard& operator=(const CBoard& aCls);
+    CBoard& operator=(const CBoard& aCls) = delete;
 
     // Workers.
     void Create(u32 uCellSz, SPoint aqCenter);
     void Destroy();
 
+    bool SaveTemplate(const QString& sPath);
+    bool LoadTemplate(const QString& sPath, u32 uCellSz);
+    bool LoadColors(const CCellSnapshot& aSnapshot);
+
     void Draw(QPainter *pPainter = nullptr);
 
+    void PublishSnapshot();
+
     // Getters.
     u32 GetBoardSize();
     float GetCombSize();
@@ -41,25 +98,93 @@ public:
     std::vector<CCell*> GetCellNeighbors(CHoneyComb* pComb = nullptr, u32 uCellIdx = 0);
     std::vector<CCell*> GetCellNeighbors(u32 uCombIdx = 0, u32 uCellIdx = 0);
 
-    std::vector<CNation*> GetNationList();
-    std::map<u64, CCell*> GetCellMap();
+    u32 GetCellCount();
+    u32 GetNumValidCells();
+    u32 GetColorCount(ECellColors eClr);
+    bool ColorDominates(ECellColors eClr, float nShare);
+    u32 GetCellIndex(u64 uCellID);
+    CCell* GetCell(u32 uCellIdx);
+    CCellStore* GetCellStore();
+    CTerritories* GetTerritories();
+    CDistanceFields* GetDistanceFields();
+    std::shared_ptr<const CCellSnapshot> GetSnapshot();
+    u32 GetNeighborIndices(u32 uCellIdx, u32* pNeighbors);
+
+    void GetNeighborCells(const CCellBitset& aCells, CCellBitset& aNeighbors);
+
+    bool NationsBorder(ECellColors eAggressor, ECellColors eVictim);
+    const CCellBitset& GetFrontier(ECellColors eAggressor, ECellColors eVictim);
+    u32 FloodFill(ECellColors eAggressor, ECellColors eVictim, u32 uMaxCells, std::vector<u32>* pTaken = nullptr);
+    u32 InfectionStep(ECellColors eAggressor, ECellColors eVictim, float nChance, u64 uSeed, CCellBitset& aInfected);
+    u32 Infect(ECellColors eAggressor, ECellColors eVictim, float nChance, u64 uSeed, u32 uMaxCells, std::vector<u32>* pTaken = nullptr);
+
+    u32 CoordToIndex(const SHexCoord& aCoord);
+    SHexCoord IndexToCoord(u32 uCellIdx);
+    SPoint CoordToPixel(const SHexCoord& aCoord);
+    SHexCoord PixelToCoord(const SPoint& aPt);
+
+    u32 GetCellIdxAtPoint(const SPoint& aPt);
+    CCell* GetCellAtPoint(const SPoint& aPt);
+
+    const std::vector<CNation*>& GetNationList();
 
     CNation* ColorToNation(ECellColors eColor);
 
     // Setters.
+    void SetCellColor(u32 uCellIdx, ECellColors eClr);
     void SetBoardSize(u32 uSz = 2);
+    void SetTemplateDir(const QString& sDir);
+    void SetMaxThreads(u32 uMaxThreads);
+    void SetHeadless(bool bHeadless);
 
 private:
-    std::vector<SPoint> CalcTessPos(SPoint& aStart, u32 iLayerIdx, u32 uCellSz, u32 uTessLegLen);
-    void AddCellToNation(ECellColors eClr, u64 uCellID);
+    void GenerateBoard(u32 uCellSz);
+    void AttachCombCells(bool bPlaceCells);
+    void BuildNations();
+    void BuildCellViews();
+    QString GetTemplatePath(u32 uCellSz);
+
+    void AddCellsToNation(ECellColors eClr, const CCellBitset& aCells);
+    void AddCell(CCell* pCell, ECellColors eClr);
+    void BuildAdjacency();
+    void BuildDirMasks();
+    void BuildColorCells();
+    void BuildFrontiers();
+    void UpdateFrontier(ECellColors eAggressor, ECellColors eVictim, u32 uCellIdx, bool bContested);
 
     u32 miSize; //!< Number of tessellation layers for the board. (Default = 2)
     float mnCombSz; //!< The size of a single honeycomb object (used in positioning).
+    float mnCellRadius; //!< Circumradius of a cell in pixels (used to go from lattice coordinates to pixels).
+    SPoint mCenter; //!< Pixel center of the board, this is where lattice coordinate (0, 0) sits.
+    QString msTemplateDir; //!< Directory board templates are cached in, empty to always generate the board.
+    u32 muMaxThreads; //!< Most threads InfectionStep may split a round over, 0 for one per core.
+    CWorkerPool* mpInfectPool; //!< Threads InfectionStep splits rounds over, started the first time a round is big enough (owned, kept until the board goes).
+    bool mbHeadless; //!< Is this board only played on, never shown? (no logging or territories, see SetHeadless)
+
+    CArena<CHoneyComb> mCombArena; //!< Storage for the board honeycombs, reset (not freed) by "Destroy" so the next board reuses it.
+    CArena<CNation> mNationArena; //!< Storage for the board nations, reset (not freed) by "Destroy" so the next board reuses it.
 
-    std::vector<CHoneyComb*> mpBoardCombs; //!< Board honeycombs. (array of pointers)
+    std::vector<CHoneyComb*> mpBoardCombs; //!< Board honeycombs. (array of pointers into mCombArena)
     std::map<ECellColors, u32> mColorLastMap; //!< Map used as reference for finding the last comb a color successfully "attacked".
-    std::vector<CNation*> mvNations; //!< Vector of pointers to the current (live) nations at play.
-    std::map<u64, CCell*> mmCellMap; //!< This is a cell map for easy cell location based on X,Y coordinates.
+    std::vector<CNation*> mvNations; //!< Vector of pointers to the current (live) nations at play. (pointers into mNationArena)
+
+    CCellStore mCellStore; //!< Contiguous per-cell state (centers, colors, validity) by cell index.
+    std::vector<std::vector<CCell>> mvCellTiles; //!< Cell views, tiled like the cell store (empty where the store has no tile).
+    std::vector<s32> mvDirShifts; //!< Per direction, the cell index offset to the neighbor in that direction (constant over the whole board).
+    std::vector<CCellBitset> mvDirMasks; //!< Per direction, the cells that have a neighbor in that direction.
+    std::vector<CCellBitset> mvColorCells; //!< Per color (by palette index), the cells of that color as of the last BuildColorCells (not kept up to date).
+    std::vector<CCellBitset> mvFrontiers; //!< Per (aggressor, victim) color pair, the victim cells touching the aggressor. (sized on first use)
+    std::vector<u32> mvFrontierSizes; //!< Number of cells in each of mvFrontiers.
+    CCellBitset mEmptyFrontier; //!< Returned for color pairs that have never touched.
+    std::vector<u32> mvColorCounts; //!< Number of cells of each color (by palette index), kept up to date by SetCellColor.
+    u32 muNumValidCells; //!< Number of actual cells on the board.
+    std::vector<u32> mvFillQueue; //!< Scratch search queue for FloodFill (and pick list for Infect), kept between moves so it doesn't reallocate.
+    CCellBitset mFillVisited; //!< Scratch set of the cells FloodFill has queued (always left empty).
+    CCellBitset mInfected; //!< Scratch set of the cells an Infect round picked.
+    CTerritories mTerritories; //!< Connected regions of each color, kept up to date by SetCellColor.
+    CDistanceFields mDistances; //!< Distance of every cell from each color, repaired around the cells SetCellColor changes.
+
+    std::shared_ptr<const CCellSnapshot> mpSnapshot; //!< Last published cell state, only ever swapped atomically (see PublishSnapshot).
 };
 
 #endif // BOARD_H
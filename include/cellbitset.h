@@ -0,0 +1,75 @@
+#ifndef CELLBITSET_H
+#define CELLBITSET_H
+
+#include "include/globals.h"
+
+/*!
+ * \brief The CCellBitset class
+ *
+ * This class is a fixed-size set of cell indices stored one bit per cell, packed into 64-bit words. Set operations (and, or, and-not, counting) work a whole word
+ * at a time, and "OrShifted" moves a masked copy of another set by a constant number of cells. Combined with the board's per-direction shift and mask tables, that
+ * turns "which cells of B touch A" into a handful of word-wide passes instead of a neighbor walk per cell.
+ *
+ * The word loops are kept branch-free so the compiler can vectorize them (Sample alone skips words with nothing to pick from, see there). Iterating the set (begin/end) walks the set bits in index order without allocating.
+ *
+ * \note Sets being combined must be the same size (the cell count of the board they index).
+ */
+class CCellBitset
+{
+public:
+    //! Forward iterator over the indices in a set, in increasing order.
+    class CIterator
+    {
+    public:
+        CIterator(const CCellBitset* pSet, u32 uIdx);
+
+        u32 operator*() const;
+        CIterator& operator++();
+        bool operator==(const CIterator& aOther) const;
+        bool operator!=(const CIterator& aOther) const;
+
+    private:
+        const CCellBitset* mpSet; //!< Set being walked.
+        u32 muIdx; //!< Current index, INVALID_CELL_IDX once past the end.
+    };
+
+    CCellBitset();
+    CCellBitset(const CCellBitset& aCls);
+    CCellBitset(CCellBitset&& aCls) noexcept;
+    ~CCellBitset();
+
+    CCellBitset& operator=(const CCellBitset& aCls);
+    CCellBitset& operator=(CCellBitset&& aCls) noexcept;
+
+    // Workers.
+    void Resize(u32 uNumBits);
+    void Clear();
+
+    void Set(u32 uIdx);
+    void Reset(u32 uIdx);
+    bool Test(u32 uIdx) const;
+
+    void And(const CCellBitset& aOther);
+    void Or(const CCellBitset& aOther);
+    void AndNot(const CCellBitset& aOther);
+    void OrShifted(const CCellBitset& aSrc, const CCellBitset& aMask, s32 iShift);
+    void Sample(const CCellBitset& aSrc, u64 uThreshold, u64 uSeed, u32 uFirstWord, u32 uEndWord);
+
+    u32 Count() const;
+    bool Any() const;
+    u32 FindNext(u32 uFrom = 0) const;
+
+    // Getters.
+    CIterator begin() const;
+    CIterator end() const;
+
+    u32 GetSize() const;
+    u32 GetNumWords() const;
+    const u64* GetWords() const;
+
+private:
+    std::vector<u64> mvWords; //!< Bit "i" lives in word i / WORD_SZ at bit i % WORD_SZ.
+    u32 muNumBits; //!< Number of cells in the set (bits past this are always zero).
+};
+
+#endif // CELLBITSET_H
@@ -0,0 +1,159 @@
+#ifndef CELLSTORE_H
+#define CELLSTORE_H
+
+#include <memory>
+#include "include/globals.h"
+#include "include/palette.h"
+
+#if !defined(INVALID_CELL_IDX)
+#define INVALID_CELL_IDX (0xffffffff) //!< Returned by cell index lookups when the cell doesn't exist.
+#endif // #if !defined(INVALID_CELL_IDX)
+
+#if !defined(_CELL_TILES)
+#define _CELL_TILES
+#define CELL_TILE_SHIFT (12)
+#define CELL_TILE_SZ (1 << CELL_TILE_SHIFT) //!< Number of consecutive cell indices in a tile (4096).
+#define CELL_TILE_MASK (CELL_TILE_SZ - 1)
+#endif // #if !defined(_CELL_TILES)
+
+/*!
+ * \brief The SCellTile struct
+ *
+ * This is a fixed-size run of CELL_TILE_SZ consecutive cell indices, holding the state of those cells as a structure of arrays. Index "i" of the store lives in tile
+ * i >> CELL_TILE_SHIFT at slot i & CELL_TILE_MASK.
+ */
+struct SCellTile
+{
+    float mnCenterX[CELL_TILE_SZ]; //!< Pixel center X of each cell.
+    float mnCenterY[CELL_TILE_SZ]; //!< Pixel center Y of each cell.
+    u8 muColor[CELL_TILE_SZ]; //!< Palette index (see "include/palette.h") of each cell's color.
+    u32 muComb[CELL_TILE_SZ]; //!< Index of the honeycomb each cell belongs to, INVALID_CELL_IDX if none.
+    u8 muValid[CELL_TILE_SZ]; //!< Non-zero if the index is an actual cell on the board.
+    u8 muNeighbors[CELL_TILE_SZ]; //!< Bit "d" is set if the neighbor in direction "d" (see SHexCoord::Neighbor) is a cell on the board.
+    u32 muNumValid; //!< Number of valid cells in the tile.
+    u64 muVersion; //!< Store version of the last write to the tile (see CCellStore::GetVersion).
+};
+
+/*!
+ * \brief The CCellSnapshot class
+ *
+ * This class is an immutable view of a cell store's tiles as of one store version (see CCellStore::Snapshot). It holds a reference on every tile it covers, and the
+ * store copies a tile before writing to it while anything else still references it, so a snapshot never changes underneath it's readers. That lets other threads
+ * (rendering, network sync, stats) read a consistent board without taking any locks, and only the tiles written since cost any memory.
+ */
+class CCellSnapshot
+{
+public:
+    CCellSnapshot();
+    ~CCellSnapshot();
+
+    // Workers.
+    SHexCoord IndexToCoord(u32 uCellIdx) const;
+
+    // Getters.
+    u32 GetCount() const;
+    u64 GetVersion() const;
+    u32 GetNumTiles() const;
+    const SCellTile* GetTile(u32 uTile) const;
+
+    bool IsValid(u32 uCellIdx) const;
+    SPoint GetCenter(u32 uCellIdx) const;
+    ECellColors GetColor(u32 uCellIdx) const;
+    u8 GetColorIdx(u32 uCellIdx) const;
+
+private:
+    friend class CCellStore;
+
+    SHexCoord mMin; //!< Smallest axial coordinate of the bounding box (cell index 0).
+    u32 muSpanQ; //!< Number of axial columns in the bounding box.
+    u32 muCount; //!< Number of cell indices.
+    u64 muVersion; //!< Store version the snapshot was taken at.
+
+    std::vector<std::shared_ptr<const SCellTile>> mvTiles; //!< Tiles by tile index, nullptr where the store had none.
+};
+
+/*!
+ * \brief The CCellStore class
+ *
+ * This class owns the per-cell state of a board as a structure of arrays: center X, center Y, color, validity, owning honeycomb and neighbors of every cell.
+ * Cells are addressed by their "cell index", which is their position in the row-major layout of the board's axial bounding box. Indices that fall outside the board are
+ * simply flagged as invalid. CCell and CHoneyComb objects are views into this store, so anything that walks the whole board (drawing, diffs, fills) can stream straight
+ * through these arrays instead.
+ *
+ * The arrays are split into fixed-size tiles (see SCellTile) that are only allocated once a cell inside them is made valid, so the empty corners of the bounding
+ * box never take up memory and huge boards only pay for the cells they have. Every write stamps the tile with a new store version, so readers that remember the
+ * version they last looked at can skip the tiles that haven't changed since.
+ *
+ * Tiles are reference counted and copied on write: copying the store, or taking a snapshot of it, only shares the tiles, and a shared tile is duplicated the first time
+ * it's written to afterwards.
+ *
+ * Neighbors aren't stored as indices: the neighbor in direction "d" is always GetDirShift(d) indices away, the per-cell mask only says which of them exist.
+ *
+ * \note All cells in a store share the same size.
+ */
+class CCellStore
+{
+public:
+    CCellStore();
+    CCellStore(const CCellStore& aCls);
+    CCellStore(CCellStore&& aCls) noexcept;
+    ~CCellStore();
+
+    CCellStore& operator=(const CCellStore& aCls);
+    CCellStore& operator=(CCellStore&& aCls) noexcept;
+
+    // Workers.
+    void Create(const SHexCoord& aMin, u32 uSpanQ, u32 uSpanR, float nCellSize);
+    void Destroy();
+
+    u32 CoordToIndex(const SHexCoord& aCoord);
+    SHexCoord IndexToCoord(u32 uCellIdx);
+
+    void BuildNeighbors();
+    u32 GetNeighborIndices(u32 uCellIdx, u32* pNeighbors);
+
+    // Getters.
+    u32 GetCount();
+    u32 GetSpanQ();
+    u32 GetSpanR();
+    float GetCellSize();
+    s32 GetDirShift(u32 uDir);
+
+    bool IsValid(u32 uCellIdx);
+    SPoint GetCenter(u32 uCellIdx);
+    ECellColors GetColor(u32 uCellIdx);
+    u8 GetColorIdx(u32 uCellIdx);
+    u32 GetComb(u32 uCellIdx);
+    u8 GetNeighborMask(u32 uCellIdx);
+
+    u32 GetNumTiles();
+    const SCellTile* GetTile(u32 uTile);
+    u64 GetVersion();
+    std::shared_ptr<const CCellSnapshot> Snapshot();
+
+    // Setters.
+    void SetCellSize(float nCellSize);
+    void SetValid(u32 uCellIdx, bool bValid = true);
+    void SetCenter(u32 uCellIdx, const SPoint& aCenter);
+    void SetColor(u32 uCellIdx, ECellColors eClr);
+    void SetComb(u32 uCellIdx, u32 uCombIdx);
+
+    void AssignTile(u32 uTile, const float* pCentersX, const float* pCentersY, const u8* pColors, const u8* pValidity);
+
+    void PointsInCells(const float* pPointsX, const float* pPointsY, const u32* pCellIdxs, u32 uCount, u8* pInside);
+
+private:
+    SCellTile* GetTileForWrite(u32 uCellIdx, bool bAllocate = false);
+    void FreeTiles();
+
+    SHexCoord mMin; //!< Smallest axial coordinate of the bounding box (cell index 0).
+    u32 muSpanQ; //!< Number of axial columns in the bounding box.
+    u32 muSpanR; //!< Number of axial rows in the bounding box.
+    u32 muCount; //!< Number of cell indices (muSpanQ * muSpanR).
+    float mnCellSize; //!< Size of every cell in the store.
+    u64 muVersion; //!< Bumped on every write, see SCellTile::muVersion.
+
+    std::vector<std::shared_ptr<SCellTile>> mvTiles; //!< Tiles by tile index, nullptr until a cell inside the tile is made valid. May be shared with copies and snapshots.
+};
+
+#endif // CELLSTORE_H
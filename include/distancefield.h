@@ -0,0 +1,62 @@
+#ifndef DISTANCEFIELD_H
+#define DISTANCEFIELD_H
+
+#include "include/cellstore.h"
+#include "include/span.h"
+
+#if !defined(DISTANCE_UNREACHED)
+#define DISTANCE_UNREACHED (0xffffffff) //!< Distance of holes and of cells a color can't reach (e.g. the color has no cells left).
+#endif // #if !defined(DISTANCE_UNREACHED)
+
+// Define DISTANCE_CHECK_REPAIRS (e.g. "DEFINES += DISTANCE_CHECK_REPAIRS" in qmake) to check every repaired field against a fresh search, see
+// CDistanceFields::CheckField. That makes every repair cost a full search, so it's only for chasing repair bugs.
+
+/*!
+ * \brief The CDistanceFields class
+ *
+ * This class keeps, per color, how many steps every cell is from the nearest cell of that color (0 for the color's own cells). A field is computed on first use
+ * with a multi-source breadth-first search seeded from every cell of the color, and reading it after that is a single array lookup.
+ *
+ * Recolors don't touch the fields straight away, the cell is only queued on the fields of it's old and new colors. The next read of such a field repairs it around
+ * the queued cells in one batch: cells that became sources pull distances down, and for cells that stopped being sources only the cells whose shortest paths ran
+ * through them are reset and filled back in from their unaffected neighbors. Fields no one has asked for are never built or maintained.
+ */
+class CDistanceFields
+{
+public:
+    CDistanceFields();
+    CDistanceFields(const CDistanceFields& aCls);
+    ~CDistanceFields();
+
+    CDistanceFields& operator=(const CDistanceFields& aCls);
+
+    // Workers.
+    void Build(CCellStore* pStore);
+    void Destroy();
+
+    void CellRecolored(u32 uCellIdx, ECellColors eOldClr, ECellColors eNewClr);
+
+    // Getters.
+    u32 GetDistance(ECellColors eClr, u32 uCellIdx);
+    CSpan<const u32> GetField(ECellColors eClr);
+
+private:
+    void ComputeField(u8 uClr);
+    void SearchField(u8 uClr, std::vector<u32>& vField);
+    void RepairField(u8 uClr);
+    void CheckField(u8 uClr);
+    void Propagate(std::vector<u32>& vField);
+    bool Refresh(u8 uClr);
+
+    CCellStore* mpStore; //!< Cell store of the board the fields are for.
+
+    std::vector<std::vector<u32>> mvFields; //!< Per palette color, the distance of every cell (by cell index), empty until first asked for.
+    std::vector<std::vector<u32>> mvPending; //!< Per palette color, cells recolored since the field was last repaired (may repeat).
+
+    std::vector<std::vector<u32>> mvBuckets; //!< Scratch queues by distance, used to fill fields in distance order.
+    std::vector<u32> mvAffected; //!< Scratch list of cells a repair has to reset.
+    std::vector<u8> mvMarks; //!< Scratch per-cell marks used while repairing (always left cleared), allocated by the first repair.
+    std::vector<u32> mvCheck; //!< Scratch field the repairs are checked against (see DISTANCE_CHECK_REPAIRS).
+};
+
+#endif // DISTANCEFIELD_H
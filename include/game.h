@@ -8,6 +8,16 @@
 // For networking support.
 #include "include/network/network.h"
 
+#if !defined(_ODDS_LIMITS)
+#define _ODDS_LIMITS
+#define ODDS_MAX_BUDGET (30.0f) //!< Most seconds "!odds" may be asked to spend.
+#define ODDS_MAX_GAMES (1000000) //!< Most games "!odds" plays out, however long it's given.
+#endif // #if !defined(_ODDS_LIMITS)
+
+class CAutoPlayer;
+class CSimulator;
+struct SSimResults;
+
 /*!
  * \brief The CDice class
  *
@@ -19,6 +29,7 @@ class CDice
 {
 public:
     CDice();
+    explicit CDice(u32 uSeed);
     CDice(const CDice& aCls);
     ~CDice();
 
@@ -30,6 +41,7 @@ public:
 
 private:
     u32 muLastRoll;
+    std::mt19937 mEngine; //!< This die's own RNG, so dice on different threads never share state.
 };
 
 /*!
@@ -63,6 +75,10 @@ public:
 
     std::pair<bool, QString> MoveColor(ECellColors eAggressor, ECellColors eVictim, u32 uMvAmnt = 3);
 
+    static bool RollToMove(u32 uRoll, u32 uDiceMax, u32& uMvAmnt);
+    static void RollInfection(CDice& aDice, u32 uDiceMax, float& nChance, u64& uSeed);
+    static ECellColors FindWinner(CBoard* pBoard, ECellColors eAggressor);
+
     u32 DummyRoll();
 
     void Draw();
@@ -87,7 +103,7 @@ public:
 
 public slots:
     void ProcessCommand(SCommand lCmd);
-    void Net_UpdateBoard(std::map<u64, ECellColors> lClrMap);
+    void Net_UpdateBoard(const std::map<u64, ECellColors>& lClrMap);
     void Tick(); // This is used to "tick" the game and server.
 
 signals:
@@ -96,8 +112,16 @@ signals:
     void SendGUI_Redraw();
 
 private:
+    u32 ApplyMove(CNation* aAggrNation, CNation* aVictimNation, u32 uMvAmnt);
     u32 DoFloodFill(CNation* aAggrNation, CNation* aVictimNation, u32 uMvAmnt);
     u32 DoInfectionFill(CNation* aAggrNation, CNation* aVictimNation, u32 uMvAmnt);
+    void StartAutoPlay(const SCommand& lCmd);
+    void StopAutoPlay();
+    void AutoPlay();
+    void SyncClients();
+    void AnnounceWinner(ECellColors eWinner);
+    void StartOdds(const SCommand& lCmd);
+    void ReportOdds(const SSimResults& aResults);
 
     bool mbGamePlaying; //!< A simple flag to determine if the game is playing or not.
     SPoint mCenter; //!< The center of the board to draw from.
@@ -105,12 +129,17 @@ private:
 
     CDice *mpDice; //!< Pointer to the dice used to make decisions.
     CBoard *mpBoard; //!< Pointer to the active game board.
+    CAutoPlayer *mpAutoPlayer; //!< Schedules the "/auto" moves (made on first use).
+    CSimulator *mpOdds; //!< Plays out copies of the board in the background for "!odds" (made on first use).
     QImage *mpCanvas; //!< The drawing canvas for the game.
     std::vector<CNation*> mvNations; //!< Vector of pointers to the current (live) nations at play.
     u32 muDiceMax; //!< The maximum roll amount for a dice "throw".
     std::string msTmpFileName; //!< Temporary filename for the image to write to.
 
-    std::map<u64, ECellColors> mmOldBoardMap;
+    std::vector<u8> mvOldColors; //!< Cell colors (palette indices, by cell index) as last sent to the clients.
+    u64 muSyncVersion; //!< Cell store version as of the last send, tiles that weren't written since then are skipped when diffing.
+
+    std::vector<u32> mvTakenCells; //!< Scratch list of the cells a move took, kept between moves so it doesn't reallocate.
 
     CServer *mpNetServer;
     CClient *mpNetClient;
@@ -21,6 +21,7 @@
 #include <math.h>
 #include <random>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 #include <iostream>
 #include <fstream>
@@ -42,6 +43,8 @@ typedef byte u8;
 typedef unsigned short u16;
 typedef unsigned int u32;
 typedef unsigned long long u64;
+typedef signed int s32;
+typedef signed long long s64;
 #define _CUSTOM_TYPES_SET
 #endif // #if !defined(_CUSTOM_TYPES_SET)
 
@@ -50,28 +53,8 @@ typedef unsigned long long u64;
 #define SZ(x) (sizeof(x)/sizeof(*(x)))
 #endif // #if !defined(SZ)
 
-// Geometric constants.
-#if !defined(NUM_HEX_VERTS)
-#define NUM_HEX_VERTS (6)
-#endif // #if !defined(NUM_HEX_VERTS)
-
-#if !defined(_HEX_RATIOS)
-#define HEX_LONG_SHORT  (static_cast<float>(1.0f / 2.0f))
-#define HEX_SHORT_START  (static_cast<float>(1.0f / 4.0f))
-#define HEX_HALF_WIDTH  (static_cast<float>(0.864f / 1.0f))
-#define CELL_COMB_RATIO (1.71875f) //!< This is pulled from "docs/honeycomb_dissection.png". That is the value of 220/128.
-#define _HEX_RATIOS
-#endif // #if !defined(_HEX_RATIOS)
-
-#if !defined(_TESS_RATIOS)
-#define _TESS_RATIOS
-#define TESS_COMBSZ_TO_TESSSZ (static_cast<float>(2.6542f / 1.0f))
-#define TESS_NEAR_SIDE (static_cast<float>(2.308f / 1.0f))
-#define TESS_NEAR_TO_FAR (static_cast<float>(1.9932f / 1.0f))
-#define TESS_X_SHIFT (static_cast<float>(0.1864f / 1.0f))
-#define TESS_Y_SHIFT (static_cast<float>(0.9754f / 1.0f))
-#define TESS_ROTATION (10.929488f) //!< This is calculated using the values in "docs/tessellation_far_dissection.png". It's the value of tan-1(112/580).
-#endif  // #if !defined(_TESS_RATIOS)
+// Geometric constants (hexagon ratios, unit vertices, neighbor and tessellation offsets).
+#include "include/hexgeometry.h"
 
 #if !defined(M_PI)
 #define M_PI (3.14159265359)
@@ -108,6 +91,7 @@ enum ECellColors
     Cell_Gray = 0xc00d,
     Comb_Mixed = 0xcff1 //!< Only used by honeycombs and not individual cells!
 };
+#define NUM_CELL_COLORS (Cell_Gray - Cell_White + 1) //!< Number of real cell colors (Cell_White through Cell_Gray).
 #endif // #if !defined(_CELL_COLORS)
 
 enum ECommand
@@ -121,6 +105,7 @@ enum ECommand
     Cmd_Help,
     Cmd_Quit,
     Cmd_Stats,
+    Cmd_Odds,
     Cmd_ConnectToServer,
     Cmd_SetupServer,
     Cmd_Unknown
@@ -142,12 +127,93 @@ struct SPoint
     SPoint(float aX, float aY) : mX{aX}, mY{aY} { /* Intentionally left blank. */ }
 };
 
+/*!
+ * \brief The SHexCoord struct
+ *
+ * Integer axial coordinates (q, r) of a cell on the hexagonal lattice. This is the canonical identity of a cell, pixel positions are derived from it and never the other way round.
+ * The implicit third cube coordinate is "s = -q - r". Rows (r) grow downwards and columns (q) grow to the right, matching our pointy-topped cells.
+ */
+struct SHexCoord
+{
+    s32 mQ; //!< Axial column.
+    s32 mR; //!< Axial row.
+
+    s32 q() const { return mQ; }
+    s32 r() const { return mR; }
+    s32 s() const { return -mQ - mR; }
+
+    SHexCoord operator +(const SHexCoord& aOther) const { return SHexCoord(mQ + aOther.mQ, mR + aOther.mR); }
+    SHexCoord operator -(const SHexCoord& aOther) const { return SHexCoord(mQ - aOther.mQ, mR - aOther.mR); }
+    SHexCoord operator *(s32 iScale) const { return SHexCoord(mQ * iScale, mR * iScale); }
+    bool operator ==(const SHexCoord& aOther) const { return mQ == aOther.mQ && mR == aOther.mR; }
+    bool operator !=(const SHexCoord& aOther) const { return !(*this == aOther); }
+
+    //! Packs the coordinate into a cell ID (q in the high word, r in the low word).
+    u64 ToID() const { return (static_cast<u64>(static_cast<u32>(mQ)) << (WORD_SZ / 2)) | static_cast<u32>(mR); }
+    static SHexCoord FromID(u64 uCellID) { return SHexCoord(static_cast<s32>(uCellID >> (WORD_SZ / 2)), static_cast<s32>(uCellID & 0xffffffff)); }
+
+    /*!
+     * \brief Neighbor
+     *
+     * Returns the neighboring coordinate in the given direction. Directions are ordered the same way the cells of a honeycomb are: left, up-left, up-right, right, down-right, down-left.
+     */
+    SHexCoord Neighbor(u32 uDir) const
+    {
+        return SHexCoord(mQ + c_iHexDirQ[uDir % NUM_HEX_VERTS], mR + c_iHexDirR[uDir % NUM_HEX_VERTS]);
+    }
+
+    /*!
+     * \brief DirectionTo
+     *
+     * Returns the direction of a neighboring coordinate (see "Neighbor"), or NUM_HEX_VERTS if the coordinate isn't a neighbor.
+     */
+    u32 DirectionTo(const SHexCoord& aOther) const
+    {
+        u32 uDir = 0;
+        while (NUM_HEX_VERTS > uDir && (mQ + c_iHexDirQ[uDir] != aOther.mQ || mR + c_iHexDirR[uDir] != aOther.mR)) { ++uDir; }
+
+        return uDir;
+    }
+
+    /*!
+     * \brief FromPixel
+     *
+     * Returns the coordinate of the hexagon containing a point, given relative to the hexagon at (0, 0) in units of the cell circum-radius. The fractional axial
+     * position is rounded in cube space, so the result is exact everywhere inside the hexagon (not just near the center).
+     */
+    static SHexCoord FromPixel(float nX, float nY)
+    {
+        const float nQ = (c_nHexSqrt3 / 3.0f) * nX - nY / 3.0f;
+        const float nR = (2.0f / 3.0f) * nY;
+        const float nS = -nQ - nR;
+
+        float nRQ = roundf(nQ);
+        float nRR = roundf(nR);
+        const float nRS = roundf(nS);
+
+        const float nDQ = fabsf(nRQ - nQ);
+        const float nDR = fabsf(nRR - nR);
+        const float nDS = fabsf(nRS - nS);
+
+        if (nDQ > nDR && nDQ > nDS) { nRQ = -nRR - nRS; }
+        else if (nDR > nDS) { nRR = -nRQ - nRS; }
+
+        return SHexCoord(static_cast<s32>(nRQ), static_cast<s32>(nRR));
+    }
+
+    SHexCoord() : mQ{0}, mR{0} { /* Intentionally left blank. */ }
+    SHexCoord(s32 iQ, s32 iR) : mQ{iQ}, mR{iR} { /* Intentionally left blank. */ }
+};
+
 struct CfgVars
 {
     bool mbIsDebug = false; //!< Are we in a debugging mode?
     std::string msProgName = "ColorWars"; //!< The name of the program.
     std::string msLogName = ""; //!< The log filename to write to.
     std::string msRootDir = "./"; //!< The root directory for the game.
+    float mnWinShare = 0.75f; //!< Share of the board's cells (0 - 1] a color has to hold to win, 1 means it has to be the last color standing.
+    bool mbInfection = false; //!< Do moves spread by infection rounds (see CGame::DoInfectionFill) instead of flood fills?
+    float mnOddsBudget = 2.0f; //!< Seconds "!odds" spends playing out the current board, unless it's given a time.
 };
 
 struct SCommand
@@ -162,8 +228,6 @@ struct SCommand
 };
 
 // External functions and variables.
-extern std::map<ECellColors, QString> g_ColorNameMap;
-extern std::map<std::string, ECellColors> g_NameToColorMap;
 extern CfgVars g_cfgVars;
 
 extern SCommand ParseCommandString(QString lStr, std::string sSender = "", u32 uSenderID = 0);
@@ -0,0 +1,86 @@
+#ifndef HEXGEOMETRY_H
+#define HEXGEOMETRY_H
+
+/*
+ * Compile-time hexagon geometry.
+ *
+ * Every hexagon on the board is the same pointy-top hexagon (long-leg vertical), so all the trigonometry is done once, here, as constant tables. Anything that
+ * positions, draws or walks cells reads from these tables instead of calling sin/cos/sqrt per cell.
+ *
+ * Pixel tables are in units of the cell circum-radius (half the cell size), with Y growing down the screen like Qt's.
+ */
+
+// Geometric constants.
+#if !defined(NUM_HEX_VERTS)
+#define NUM_HEX_VERTS (6)
+#endif // #if !defined(NUM_HEX_VERTS)
+
+#if !defined(_HEX_RATIOS)
+#define HEX_LONG_SHORT  (static_cast<float>(1.0f / 2.0f))
+#define HEX_SHORT_START  (static_cast<float>(1.0f / 4.0f))
+#define HEX_HALF_WIDTH  (static_cast<float>(0.864f / 1.0f))
+#define CELL_COMB_RATIO (1.71875f) //!< This is pulled from "docs/honeycomb_dissection.png". That is the value of 220/128.
+#define _HEX_RATIOS
+#endif // #if !defined(_HEX_RATIOS)
+
+#if !defined(_TESS_RATIOS)
+#define _TESS_RATIOS
+#define TESS_COMBSZ_TO_TESSSZ (static_cast<float>(2.6542f / 1.0f))
+#define TESS_NEAR_SIDE (static_cast<float>(2.308f / 1.0f))
+#define TESS_NEAR_TO_FAR (static_cast<float>(1.9932f / 1.0f))
+#define TESS_X_SHIFT (static_cast<float>(0.1864f / 1.0f))
+#define TESS_Y_SHIFT (static_cast<float>(0.9754f / 1.0f))
+#define TESS_ROTATION (10.929488f) //!< This is calculated using the values in "docs/tessellation_far_dissection.png". It's the value of tan-1(112/580).
+#endif  // #if !defined(_TESS_RATIOS)
+
+constexpr float c_nHexSqrt3 = 1.7320508f; //!< sqrt(3), the center-to-center distance of neighboring cells (in circum-radii).
+constexpr float c_nHexHalfSqrt3 = 0.8660254f; //!< sqrt(3) / 2, the in-radius of a cell (in circum-radii).
+constexpr float c_nHexInvSqrt3 = 0.57735027f; //!< 1 / sqrt(3), the slope of the slanted hexagon edges (|dy| per |dx|).
+
+//! Unit hexagon vertices, starting at the top and going counter-clockwise on screen.
+constexpr float c_nHexVertX[NUM_HEX_VERTS] = { 0.0f, -c_nHexHalfSqrt3, -c_nHexHalfSqrt3, 0.0f, c_nHexHalfSqrt3, c_nHexHalfSqrt3 };
+constexpr float c_nHexVertY[NUM_HEX_VERTS] = { -1.0f, -0.5f, 0.5f, 1.0f, 0.5f, -0.5f };
+
+//! Axial steps to each neighbor: left, up-left, up-right, right, down-right, down-left (clockwise on screen).
+constexpr s32 c_iHexDirQ[NUM_HEX_VERTS] = { -1, 0, 1, 1, 0, -1 };
+constexpr s32 c_iHexDirR[NUM_HEX_VERTS] = { 0, -1, -1, 0, 1, 1 };
+
+//! Pixel offsets to each neighbor's center, in the same order as c_iHexDirQ/c_iHexDirR.
+constexpr float c_nHexDirX[NUM_HEX_VERTS] = { -c_nHexSqrt3, -c_nHexHalfSqrt3, c_nHexHalfSqrt3, c_nHexSqrt3, c_nHexHalfSqrt3, -c_nHexHalfSqrt3 };
+constexpr float c_nHexDirY[NUM_HEX_VERTS] = { 0.0f, -1.5f, -1.5f, 0.0f, 1.5f, 1.5f };
+
+/*!
+ * \brief HexContains
+ *
+ * Exact test for a point being inside a hexagon. The point is folded into the first quadrant (the hexagon is symmetric on both axes), after which it only has to be
+ * left of the vertical edge and below the slanted edge. That's two compares and a multiply, no square roots and no branches.
+ *
+ * \param nDX - X offset of the point from the hexagon center.
+ * \param nDY - Y offset of the point from the hexagon center.
+ * \param nCircumRadius - Circum-radius of the hexagon (half the cell size).
+ * \return True if the point is inside (or on the edge of) the hexagon.
+ */
+constexpr bool HexContains(float nDX, float nDY, float nCircumRadius)
+{
+    return (((0.0f > nDX) ? -nDX : nDX) <= c_nHexHalfSqrt3 * nCircumRadius) &
+           ((((0.0f > nDX) ? -nDX : nDX) * c_nHexInvSqrt3 + ((0.0f > nDY) ? -nDY : nDY)) <= nCircumRadius);
+}
+
+/*
+ * Honeycomb tessellation offsets.
+ *
+ * A honeycomb is a cell plus it's six neighbors, and honeycombs tile the board on a super-lattice spanned by (2, -3) and it's 60-degree rotations. That basis is
+ * the TESS_ROTATION tilt in "docs/tessellation_far_dissection.png". Entry "n" is the (2, -3) step rotated "n" times by 60 degrees counter-clockwise on screen,
+ * which in axial coordinates is (q, r) -> (q + r, -q).
+ */
+constexpr s32 c_iCombStepQ[NUM_HEX_VERTS] = { 2, -1, -3, -2, 1, 3 };
+constexpr s32 c_iCombStepR[NUM_HEX_VERTS] = { -3, -2, 1, 3, 2, -1 };
+
+static_assert(c_iCombStepQ[1] == c_iCombStepQ[0] + c_iCombStepR[0] && c_iCombStepR[1] == -c_iCombStepQ[0], "Comb step 1 must be step 0 rotated by 60 degrees!");
+static_assert(c_iCombStepQ[2] == c_iCombStepQ[1] + c_iCombStepR[1] && c_iCombStepR[2] == -c_iCombStepQ[1], "Comb step 2 must be step 1 rotated by 60 degrees!");
+static_assert(c_iCombStepQ[3] == c_iCombStepQ[2] + c_iCombStepR[2] && c_iCombStepR[3] == -c_iCombStepQ[2], "Comb step 3 must be step 2 rotated by 60 degrees!");
+static_assert(c_iCombStepQ[4] == c_iCombStepQ[3] + c_iCombStepR[3] && c_iCombStepR[4] == -c_iCombStepQ[3], "Comb step 4 must be step 3 rotated by 60 degrees!");
+static_assert(c_iCombStepQ[5] == c_iCombStepQ[4] + c_iCombStepR[4] && c_iCombStepR[5] == -c_iCombStepQ[4], "Comb step 5 must be step 4 rotated by 60 degrees!");
+static_assert(c_iCombStepQ[0] == c_iCombStepQ[5] + c_iCombStepR[5] && c_iCombStepR[0] == -c_iCombStepQ[5], "Comb step 0 must be step 5 rotated by 60 degrees!");
+
+#endif // HEXGEOMETRY_H
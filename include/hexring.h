@@ -0,0 +1,239 @@
+#ifndef HEXRING_H
+#define HEXRING_H
+
+#include "include/globals.h"
+
+/*
+ * Ring and spiral walks over lattice coordinates.
+ *
+ * Ring "k" around a coordinate is every coordinate exactly "k" steps away, and a spiral is rings 0 through "k" one after the other. Both are walked straight off
+ * the axial step tables, nothing is searched for and nothing is allocated: a ring starts "k" steps out along direction 0 and walks it's six sides, "k" steps each,
+ * turning 120 degrees from the starting direction (the side of a hexagon two directions on).
+ *
+ * By default the walk is over cells (c_iHexDirQ/c_iHexDirR). Passing the honeycomb steps (c_iCombStepQ/c_iCombStepR) walks the honeycomb super-lattice instead,
+ * which is how the board lays out it's combs. Any table of six steps where each is the last one rotated by 60 degrees works.
+ */
+
+//! Number of coordinates in ring "uRadius".
+constexpr u32 HexRingSize(u32 uRadius)
+{
+    return (0 == uRadius) ? 1 : NUM_HEX_VERTS * uRadius;
+}
+
+//! Number of coordinates in a spiral out to ring "uRadius" (rings 0 through uRadius).
+constexpr u32 HexSpiralSize(u32 uRadius)
+{
+    return 3 * uRadius * (uRadius + 1) + 1;
+}
+
+/*!
+ * \brief The CHexRing class
+ *
+ * This class is a ring of coordinates around a center, walked with begin/end (so range-based for loops work). Cells are visited in ring order: the first one is
+ * "uRadius" steps along direction 0 and each one after that is a neighbor of the last.
+ *
+ * \code
+ *  for (const SHexCoord& lCoord : CHexRing(lCenter, 3))
+ *  {
+ *      const u32 c_uCellIdx = pBoard->CoordToIndex(lCoord); // INVALID_CELL_IDX off the board.
+ *  }
+ * \endcode
+ */
+class CHexRing
+{
+public:
+    //! Forward iterator over the coordinates of a ring.
+    class CIterator
+    {
+    public:
+        CIterator(const SHexCoord& aCenter, u32 uRadius, const s32* pStepQ, const s32* pStepR, u32 uIdx)
+            : mpStepQ{pStepQ}, mpStepR{pStepR}, mCoord{aCenter + SHexCoord(pStepQ[0], pStepR[0]) * static_cast<s32>(uRadius)}, muRadius{uRadius}, muSide{0},
+              muStep{0}, muIdx{uIdx}
+        {
+            // Intentionally left blank.
+        }
+
+        const SHexCoord& operator*() const
+        {
+            return mCoord;
+        }
+
+        const SHexCoord* operator->() const
+        {
+            return &mCoord;
+        }
+
+        CIterator& operator++()
+        {
+            ++muIdx;
+            if (0 < muRadius)
+            {
+                const u32 c_uDir = (muSide + 2) % NUM_HEX_VERTS;
+                mCoord = mCoord + SHexCoord(mpStepQ[c_uDir], mpStepR[c_uDir]);
+                if (muRadius == ++muStep)
+                {
+                    muStep = 0;
+                    ++muSide;
+                }
+            }
+
+            return *this;
+        }
+
+        bool operator==(const CIterator& aOther) const
+        {
+            return muIdx == aOther.muIdx;
+        }
+
+        bool operator!=(const CIterator& aOther) const
+        {
+            return muIdx != aOther.muIdx;
+        }
+
+        //! Returns the radius of the ring being walked.
+        u32 GetRadius() const
+        {
+            return muRadius;
+        }
+
+        //! Returns how far along the ring the iterator is (0 for the first coordinate).
+        u32 GetIndex() const
+        {
+            return muIdx;
+        }
+
+        //! Returns true once every coordinate of the ring has been visited.
+        bool AtEnd() const
+        {
+            return HexRingSize(muRadius) <= muIdx;
+        }
+
+    private:
+        const s32* mpStepQ; //!< Axial Q of each of the six lattice steps.
+        const s32* mpStepR; //!< Axial R of each of the six lattice steps.
+        SHexCoord mCoord; //!< Current coordinate.
+        u32 muRadius; //!< Radius of the ring.
+        u32 muSide; //!< Side of the ring being walked (0 to 5).
+        u32 muStep; //!< Steps taken along the current side.
+        u32 muIdx; //!< Coordinates visited so far.
+    };
+
+    CHexRing(const SHexCoord& aCenter, u32 uRadius, const s32* pStepQ = c_iHexDirQ, const s32* pStepR = c_iHexDirR)
+        : mCenter{aCenter}, muRadius{uRadius}, mpStepQ{pStepQ}, mpStepR{pStepR}
+    {
+        // Intentionally left blank.
+    }
+
+    // Getters.
+    CIterator begin() const
+    {
+        return CIterator(mCenter, muRadius, mpStepQ, mpStepR, 0);
+    }
+
+    CIterator end() const
+    {
+        return CIterator(mCenter, muRadius, mpStepQ, mpStepR, HexRingSize(muRadius));
+    }
+
+    u32 size() const
+    {
+        return HexRingSize(muRadius);
+    }
+
+private:
+    SHexCoord mCenter; //!< Coordinate the ring is around.
+    u32 muRadius; //!< Distance of the ring from the center.
+    const s32* mpStepQ; //!< Axial Q of each of the six lattice steps.
+    const s32* mpStepR; //!< Axial R of each of the six lattice steps.
+};
+
+/*!
+ * \brief The CHexSpiral class
+ *
+ * This class is every coordinate within a distance of a center, walked ring by ring from the center out (each ring in CHexRing order). The iterator knows which
+ * ring it's on, so callers that treat rings differently don't need a walk per ring.
+ */
+class CHexSpiral
+{
+public:
+    //! Forward iterator over the coordinates of a spiral.
+    class CIterator
+    {
+    public:
+        CIterator(const SHexCoord& aCenter, u32 uRadius, const s32* pStepQ, const s32* pStepR)
+            : mCenter{aCenter}, mRing{aCenter, uRadius, pStepQ, pStepR, 0}, mpStepQ{pStepQ}, mpStepR{pStepR}
+        {
+            // Intentionally left blank.
+        }
+
+        const SHexCoord& operator*() const
+        {
+            return *mRing;
+        }
+
+        const SHexCoord* operator->() const
+        {
+            return &(*mRing);
+        }
+
+        CIterator& operator++()
+        {
+            ++mRing;
+            if (mRing.AtEnd()) { mRing = CHexRing::CIterator(mCenter, mRing.GetRadius() + 1, mpStepQ, mpStepR, 0); }
+
+            return *this;
+        }
+
+        bool operator==(const CIterator& aOther) const
+        {
+            return mRing.GetRadius() == aOther.mRing.GetRadius() && mRing.GetIndex() == aOther.mRing.GetIndex();
+        }
+
+        bool operator!=(const CIterator& aOther) const
+        {
+            return !(*this == aOther);
+        }
+
+        //! Returns the ring the iterator is on (0 for the center).
+        u32 GetRadius() const
+        {
+            return mRing.GetRadius();
+        }
+
+    private:
+        SHexCoord mCenter; //!< Coordinate the spiral is around.
+        CHexRing::CIterator mRing; //!< Position on the current ring.
+        const s32* mpStepQ; //!< Axial Q of each of the six lattice steps.
+        const s32* mpStepR; //!< Axial R of each of the six lattice steps.
+    };
+
+    CHexSpiral(const SHexCoord& aCenter, u32 uRadius, const s32* pStepQ = c_iHexDirQ, const s32* pStepR = c_iHexDirR)
+        : mCenter{aCenter}, muRadius{uRadius}, mpStepQ{pStepQ}, mpStepR{pStepR}
+    {
+        // Intentionally left blank.
+    }
+
+    // Getters.
+    CIterator begin() const
+    {
+        return CIterator(mCenter, 0, mpStepQ, mpStepR);
+    }
+
+    CIterator end() const
+    {
+        return CIterator(mCenter, muRadius + 1, mpStepQ, mpStepR);
+    }
+
+    u32 size() const
+    {
+        return HexSpiralSize(muRadius);
+    }
+
+private:
+    SHexCoord mCenter; //!< Coordinate the spiral is around.
+    u32 muRadius; //!< Distance of the outer-most ring from the center.
+    const s32* mpStepQ; //!< Axial Q of each of the six lattice steps.
+    const s32* mpStepR; //!< Axial R of each of the six lattice steps.
+};
+
+#endif // HEXRING_H
@@ -3,49 +3,8 @@
 
 #include <QPainter>
 #include "include/globals.h"
-
-#if !defined(_CUSTOM_TYPES_SET)
-typedef unsigned char byte;
-typedef byte u8;
-typedef unsigned short u16;
-typedef unsigned int u32;
-typedef unsigned long long u64;
-#define _CUSTOM_TYPES_SET
-#endif // #if !defined(_CUSTOM_TYPES_SET)
-
-#if !defined(NUM_HEX_VERTS)
-#define NUM_HEX_VERTS (6)
-#endif // #if !defined(NUM_HEX_VERTS)
-
-#if !defined(SZ)
-#define SZ(x) (sizeof(x)/sizeof(*(x)))
-#endif // #if !defined(SZ)
-
-#if !defined(_HEX_RATIOS)
-#define HEX_LONG_SHORT  (static_cast<float>(1.0f / 2.0f))
-#define HEX_SHORT_START  (static_cast<float>(1.0f / 4.0f))
-#define HEX_HALF_WIDTH  (static_cast<float>(0.864f / 1.0f))
-#define _HEX_RATIOS
-#endif // #if !defined(_HEX_RATIOS)
-
-#if !defined(_CELL_COLORS)
-#define _CELL_COLORS
-enum ECellColors
-{
-    Cell_White,
-    Cell_Red,
-    Cell_Orange,
-    Cell_Yellow,
-    Cell_Lime,
-    Cell_Green,
-    Cell_Cyan,
-    Cell_Blue,
-    Cell_Purple,
-    Cell_Magenta,
-    Cell_Pink
-};
-#endif // #if !defined(_CELL_COLORS)
-
+#include "include/cellstore.h"
+#include "include/span.h"
 
 /*!
  * \brief The CCell class
@@ -55,12 +14,15 @@ enum ECellColors
  * This class is also responsible for drawing the object to a device context (usually QPainter or HDC). This is important as this means that the object MUST take a device context
  * as an argument for it's "Draw" method.
  *
+ * A cell doesn't hold any state of it's own, it's a view onto one index of a CCellStore (which is owned by the board). Copying a cell copies the view, not the cell.
+ *
  * \note All the calculations in this class are approximate!
  */
 class CCell
 {
 public:
     CCell();
+    CCell(CCellStore* pStore, u32 uCellIdx);
     CCell(const CCell& aCls);
     ~CCell();
 
@@ -74,9 +36,11 @@ public:
 
     // Getters.
     float GetSize();
-    const SPoint& GetCenter();
-    const SPoint& GetPosition();
+    SPoint GetCenter();
+    SPoint GetPosition();
+    SHexCoord GetCoord();
     ECellColors GetColor();
+    u32 GetIndex();
 
     bool IsValid();
 
@@ -87,10 +51,8 @@ public:
     void SetColor(ECellColors aeClr = Cell_White);
 
 private:
-    bool mbIsValid; //!< Is this cell valid (has position and size)?
-    float mnSize; //!< The size of the hexagon.
-    SPoint mPosition; //!< The position of the hexagon in pixels.
-    ECellColors meClr; //!< Color to fill the cell with.
+    CCellStore* mpStore; //!< The store holding this cell's state.
+    u32 muIdx; //!< Index of this cell in the store.
 };
 
 
@@ -101,13 +63,17 @@ private:
  * using approximate values pulled from "docs/honeycomb_dissection.png". These values are NOT intended to be accurate, only "good enough".
  *
  * It's important to note that this class doesn't actually draw anything, but has a "Draw" method. This method simply iterates over the cells and cascades into their "Draw" methods.
+ * The honeycomb doesn't own it's cells either, they're views handed to it by the board through "SetCells".
+ *
+ * Each honeycomb keeps a count of it's cells per color, so color questions about a comb never need to visit it's cells. Whoever recolors a cell must report it
+ * through "CellColorChanged" (the board does this in "CBoard::SetCellColor"). The comb color doubles as the "all one color" flag, it's Comb_Mixed otherwise.
  *
  * \note All the calculations in this class are approximate!
  */
 class CHoneyComb
 {
     // Constants!
-    const u32 c_iMaxCells = (NUM_HEX_VERTS+1); //!< Maxium number of cells for a honeycomb. We add 1 as honeycombs have a center cell.
+    static const u32 c_iMaxCells = (NUM_HEX_VERTS+1); //!< Maxium number of cells for a honeycomb. We add 1 as honeycombs have a center cell.
 
 public:
     CHoneyComb();
@@ -117,7 +83,7 @@ public:
     // Overloads.
     CHoneyComb& operator =(const CHoneyComb& aCls);
     CCell* operator [](size_t iIdx); // Used to index through the cells.
-    std::vector<CCell*> operator *(); // Used to return all cells.
+    CSpan<CCell* const> operator *(); // Used to return all cells.
 
     // Workers.
     bool Draw(QPainter *pPainter = nullptr);
@@ -126,6 +92,10 @@ public:
 
     bool CombIsAllColor(ECellColors aeClr);
     bool CombContainsColor(ECellColors aeClr);
+    bool IsUniform();
+
+    void CellColorChanged(ECellColors eOldClr, ECellColors eNewClr);
+    void RecountColors();
 
     // Getters.
     bool IsInitialized();
@@ -134,10 +104,12 @@ public:
     float GetCombSize();
 
     ECellColors GetCombColor();
+    u32 GetColorCount(ECellColors aeClr);
 
     const SPoint& GetPosition();
+    const SHexCoord& GetCoord();
 
-    std::vector<CCell*> GetCells();
+    CSpan<CCell* const> GetCells();
     CCell* GetCellAt(u32 iCellIdx);
 
     CCell* GetCellNotColor(ECellColors aeClr);
@@ -152,17 +124,25 @@ public:
     // Setters.
     void SetCellSize(const float anSize);
     void SetPosition(const SPoint& aqPosition);
+    void SetCoord(const SHexCoord& aCoord);
+    void SetCells(const std::vector<CCell*>& vCells, bool bReposition = true);
     void SetCombColor(ECellColors aeClr = Cell_White);
     void SetAllCellColor(ECellColors aeClr = Cell_White);
 
 private:
     void RecalcPositions();
+    void UpdateCombColor();
+    u32 CellSlotAtPoint(const SPoint& aPt);
 
     float mnCellSize; //!< The size of the cells in pixels.
     SPoint mPosition; //!< The position of the honeycomb (and the center cell).
-    ECellColors meCombColor; //!< Color of the entire honycomb.
+    SHexCoord mCoord; //!< The axial lattice coordinate of the center cell.
+    ECellColors meCombColor; //!< Color of the entire honycomb, Comb_Mixed once it's cells differ.
 
-    std::vector<CCell*> mpCells; //!< Heap-allocated cells for the honeycomb.
+    CCell* mpCells[NUM_HEX_VERTS+1]; //!< Cells of the honeycomb (center first), these are views owned by the board. Kept inline so combs never touch the heap.
+    u32 muNumCells; //!< Number of entries of mpCells in use.
+    u8 mauColorCounts[NUM_CELL_COLORS]; //!< Number of valid cells of each color (by palette index, see "include/palette.h").
+    u8 muNumValidCells; //!< Number of valid cells (the sum of mauColorCounts).
 };
 
 #endif // #ifndef _HONEYCOMB_H
@@ -2,6 +2,7 @@
 #define NATION_H
 
 #include "include/honeycomb.h"
+#include "include/cellbitset.h"
 
 /*!
  * \brief The CNation class
@@ -10,6 +11,9 @@
  * only need be aware of the nations, who "know" where their borders are and who they border to some extent. This means that when a "move" is made, it'll be a color nation attacking
  * another color nation instead of just raw colors attacking each other. This allows the nations to always be aware of where the updated borders lie.
  *
+ * Ownership is kept as a bitset over the board's cell indices, so whole-nation questions (borders, counts) are answered a word at a time. Cell IDs are still
+ * accepted, they're translated through the board's cell store. To walk the owned cells iterate GetCells, which yields cell indices without copying anything.
+ *
  * \note This class takes NO ownership of the cells/combs it tracks! Those are left in position of their respective combs/board(s).
  */
 class CNation
@@ -17,24 +21,32 @@ class CNation
 public:
     CNation();
     CNation(const CNation& aCls);
+    CNation(CNation&& aCls) noexcept;
     ~CNation();
 
     CNation& operator=(const CNation& aCls);
+    CNation& operator=(CNation&& aCls) noexcept;
 
     CNation *operator <<(CNation &aChild);
     CNation *operator >>(CNation &aParent);
 
     // Workers.
-    void Create(ECellColors eClr = Cell_White, QString sName = "White");
+    void Create(ECellColors eClr = Cell_White, QString sName = "White", CCellStore* pStore = nullptr);
     void Destroy();
 
     bool Add(u64 uCellID);
     bool Remove(u64 uCellID);
 
+    bool AddIndex(u32 uCellIdx);
+    bool RemoveIndex(u32 uCellIdx);
+    u32 AddCells(const CCellBitset& aCells);
+    u32 RemoveCells(const CCellBitset& aCells);
+
     CNation* Merge(CNation* pMother);
 
     // Getters.
-    std::vector<u64> GetCellIDs();
+    const CCellBitset& GetCells();
+    bool OwnsIndex(u32 uCellIdx);
 
     u32 GetNationSize();
     ECellColors GetNationColor();
@@ -45,7 +57,9 @@ public:
     void SetNationName(QString sName);
 
 private:
-    std::vector<u64> mvOwnedCells; //!< Map of owned cells of certain combs.
+    CCellStore* mpStore; //!< Cell store of the board the nation lives on (used to translate cell IDs).
+    CCellBitset mOwnedCells; //!< Owned cells, one bit per board cell index.
+    u32 muNumCells; //!< Number of owned cells (kept in step with mOwnedCells).
     ECellColors meColor; //!< Color of this nation.
     QString msName; //!< Name of this nation.
 };
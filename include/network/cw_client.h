@@ -27,7 +27,7 @@ public slots:
     void HandleInput(CTcpSocket *pClient, QByteArray* pData = nullptr);
 
 signals:
-    void UpdateBoard(std::map<u64, ECellColors> mClrMap);
+    void UpdateBoard(const std::map<u64, ECellColors>& mClrMap);
 
 protected:
     QByteArray* EncodeClientUID(u32 uUID, byte bEncodeByte = 'W');
@@ -11,7 +11,7 @@ extern SCommand ParseCommandString(QString lStr); // THIS IS NOT DEFINED IN THE
 extern SCommand ParseCommandString(QString);
 #endif // #if defined(_EXTERN_CMDPARSE_FXN)
 
-extern QByteArray* PackBoardMap(std::map<u64, ECellColors> mData);
+extern QByteArray* PackBoardMap(const std::map<u64, ECellColors>& mData);
 extern std::map<u64, ECellColors> UnpackBoardMap(QByteArray* pData);
 
 #endif // CW_HELPERS_H
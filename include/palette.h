@@ -0,0 +1,75 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include "include/globals.h"
+
+/*
+ * Cell color palette.
+ *
+ * Internally a cell color is a dense palette index (0 for Cell_White up to NUM_CELL_COLORS - 1 for Cell_Gray), which is what the cell store keeps per cell (one
+ * byte each). Everything known about a color (name, RGB, the ECellColors value used on the wire) lives in a single constant table indexed by it, so converting
+ * either way is a subtraction or a table read instead of a map lookup or a switch.
+ */
+
+#if !defined(PALETTE_NONE)
+#define PALETTE_NONE (0xff) //!< Palette index of anything that isn't a real cell color (e.g. Comb_Mixed).
+#endif // #if !defined(PALETTE_NONE)
+
+//! Everything about a single palette color.
+struct SColorInfo
+{
+    const char* pName; //!< Display name, also what commands accept.
+    u8 uRed; //!< Fill color, red channel.
+    u8 uGreen; //!< Fill color, green channel.
+    u8 uBlue; //!< Fill color, blue channel.
+    ECellColors eWireCode; //!< Enum value of the color, as used by the network protocol.
+};
+
+constexpr SColorInfo c_ColorPalette[NUM_CELL_COLORS] = {
+    { "White", 255, 255, 255, Cell_White },
+    { "Red", 255, 0, 0, Cell_Red },
+    { "Orange", 255, 175, 0, Cell_Orange },
+    { "Yellow", 255, 255, 0, Cell_Yellow },
+    { "Lime", 175, 255, 0, Cell_Lime },
+    { "Green", 0, 175, 0, Cell_Green },
+    { "Cyan", 0, 255, 255, Cell_Cyan },
+    { "Blue", 0, 0, 255, Cell_Blue },
+    { "Purple", 125, 0, 255, Cell_Purple },
+    { "Magenta", 255, 0, 255, Cell_Magenta },
+    { "Pink", 255, 0, 125, Cell_Pink },
+    { "Brown", 125, 50, 0, Cell_Brown },
+    { "Gray", 125, 125, 125, Cell_Gray }
+};
+
+static_assert(NUM_CELL_COLORS < PALETTE_NONE, "Palette indices must fit in a byte!");
+static_assert(c_ColorPalette[0].eWireCode == Cell_White && c_ColorPalette[NUM_CELL_COLORS - 1].eWireCode == Cell_Gray, "Palette must run from Cell_White to Cell_Gray!");
+
+//! Converts a color to it's palette index, PALETTE_NONE if it isn't a real cell color.
+constexpr u8 ColorToPalette(ECellColors eClr)
+{
+    return (Cell_White <= eClr && Cell_Gray >= eClr) ? static_cast<u8>(eClr - Cell_White) : static_cast<u8>(PALETTE_NONE);
+}
+
+//! Converts a palette index back to it's color, Comb_Mixed if it isn't a palette index.
+constexpr ECellColors PaletteToColor(u8 uIdx)
+{
+    return (NUM_CELL_COLORS > uIdx) ? c_ColorPalette[uIdx].eWireCode : Comb_Mixed;
+}
+
+//! Returns the display name of a color, "Mixed" if it isn't a real cell color.
+inline QString ColorName(ECellColors eClr)
+{
+    const u8 c_uIdx = ColorToPalette(eClr);
+    return QString::fromLatin1((PALETTE_NONE != c_uIdx) ? c_ColorPalette[c_uIdx].pName : "Mixed");
+}
+
+//! Finds a color by it's display name (case sensitive), Comb_Mixed if there's no such color.
+inline ECellColors ColorFromName(const std::string& sName)
+{
+    u8 uIdx = 0;
+    while (NUM_CELL_COLORS > uIdx && sName != c_ColorPalette[uIdx].pName) { ++uIdx; }
+
+    return PaletteToColor(uIdx);
+}
+
+#endif // PALETTE_H
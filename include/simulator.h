@@ -0,0 +1,102 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "include/autoplay.h"
+
+#if !defined(_SIM_DEFAULTS)
+#define _SIM_DEFAULTS
+#define SIM_MAX_ROLLS (1000000) //!< Rolls a simulated game gets before it's called unfinished.
+#define SIM_CELL_SZ (128) //!< Cell size of the simulated boards (the same as the game's, so they share it's board templates).
+#define SIM_CENTER (1024) //!< Pixel center (X and Y) of the simulated boards.
+#define SIM_DEADLINE_ROLLS (1024) //!< Rolls between checks of the time budget inside a game.
+#define SIM_CONFIDENCE_Z (1.96) //!< Standard score of the win intervals (95% confidence).
+#endif // #if !defined(_SIM_DEFAULTS)
+
+//! Totals of a batch of simulated games.
+struct SSimResults
+{
+    u32 muGames = 0; //!< Games played.
+    u32 muUnfinished = 0; //!< Games that ran out of rolls before anyone won.
+    u64 muRolls = 0; //!< Dice rolls over all games.
+    u64 muMoves = 0; //!< Rolls that took at least one cell.
+    u64 muMinRolls = 0; //!< Rolls of the shortest finished game.
+    u64 muMaxRolls = 0; //!< Rolls of the longest finished game.
+    double mnSeconds = 0.0; //!< Wall-clock time of the batch.
+    u32 mvWins[NUM_CELL_COLORS] = {}; //!< Games won by each color (by palette index).
+
+    void Merge(const SSimResults& aOther);
+    void GetWinInterval(u8 uClr, double& nLow, double& nHigh) const;
+};
+
+/*!
+ * \brief The CSimulator class
+ *
+ * This class plays whole games headless, with no event loop, canvas or network: just boards, dice and the game's rules (CGame::RollToMove, CBoard::FloodFill or
+ * CBoard::Infect, CGame::FindWinner). Games are spread over a pool of worker threads, each with it's own board and dice, and the results are totalled for
+ * balancing the dice ranges, capacity planning and working out the odds of a game in progress.
+ *
+ * Every game starts from the same cell state, a fresh board unless a snapshot was given (see SetStartState), which is copied onto the worker's board with
+ * CBoard::LoadColors. The worker boards are headless (no logging or territory tracking) and are made once, on the thread that first runs a batch (the batch's own
+ * thread for RunAsync) or calls CreateBoards, and kept for later batches.
+ *
+ * Moves are picked by CRandomPolicy, the way players can make them with "!move": any live color attacks White while White is around, and another live color after
+ * that.
+ *
+ * \note The settings must not be changed while a batch is running.
+ */
+class CSimulator
+{
+public:
+    CSimulator();
+    ~CSimulator();
+
+    // Workers.
+    void CreateBoards();
+    SSimResults Run(u32 uNumGames, double nTimeBudget = 0.0);
+    bool RunAsync(u32 uNumGames, double nTimeBudget = 0.0);
+    bool PollResults(SSimResults& aResults);
+    void Cancel();
+    static void PrintResults(const SSimResults& aResults);
+
+    // Getters.
+    bool IsRunning();
+
+    // Setters.
+    void SetBoardSize(u32 uSize);
+    void SetCellSize(u32 uCellSz);
+    void SetCanvasCenter(SPoint aPt);
+    void SetDiceMax(u32 uDiceMax);
+    void SetMaxRolls(u32 uMaxRolls);
+    void SetNumThreads(u32 uNumThreads);
+    void SetSeed(u32 uSeed);
+    void SetStartState(std::shared_ptr<const CCellSnapshot> pState);
+    void SetTemplateDir(const QString& sDir);
+
+private:
+    void DestroyBoards();
+    void RunInBackground(u32 uNumGames, double nTimeBudget);
+    void PlayGames(u32 uWorker, u32 uNumGames, std::chrono::steady_clock::time_point tDeadline, std::atomic<u32>* pNextGame, SSimResults* pResults);
+
+    u32 muBoardSize; //!< Number of tessellation layers of the simulated boards.
+    u32 muCellSz; //!< Cell size of the simulated boards.
+    SPoint mCenter; //!< Pixel center of the simulated boards.
+    u32 muDiceMax; //!< The maximum roll amount for a dice "throw".
+    u32 muMaxRolls; //!< Rolls a game gets before it's called unfinished.
+    u32 muNumThreads; //!< Number of workers, 0 for one per core.
+    u32 muSeed; //!< Seed of the first worker's dice, the others count up from it.
+    QString msTemplateDir; //!< Directory board templates are cached in.
+
+    std::vector<CBoard*> mvBoards; //!< One board per worker, made by CreateBoards.
+    std::shared_ptr<const CCellSnapshot> mpStartState; //!< Cell state every game starts from, nullptr for a fresh board.
+    std::shared_ptr<const CCellSnapshot> mpFreshState; //!< Cell state of a fresh board, taken when the boards are made.
+
+    std::thread mRunner; //!< Thread of a batch started by RunAsync, joined by PollResults.
+    std::atomic<bool> mbFinished; //!< Has the background batch finished?
+    std::atomic<bool> mbCancelled; //!< Should the running batch stop as soon as it can?
+    SSimResults mAsyncResults; //!< Totals of the background batch, only read once it's finished.
+};
+
+#endif // SIMULATOR_H
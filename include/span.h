@@ -0,0 +1,67 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include "include/globals.h"
+
+/*!
+ * \brief The CSpan class
+ *
+ * This class is a non-owning view of a contiguous run of objects (a pointer and a count). Getters hand these out instead of copying their containers into a new
+ * vector, so reading through them never touches the heap. It supports range-based for loops, indexing and the usual size queries.
+ *
+ * \note A span is only valid for as long as the storage it looks at, don't hold on to one across anything that might reallocate or destroy it.
+ */
+template <typename T>
+class CSpan
+{
+public:
+    typedef T* iterator;
+    typedef T value_type;
+
+    CSpan() : mpData{nullptr}, muSize{0}
+    {
+        // Intentionally left blank.
+    }
+
+    CSpan(T* pData, size_t uSize) : mpData{pData}, muSize{(nullptr != pData) ? uSize : 0}
+    {
+        // Intentionally left blank.
+    }
+
+    T& operator[](size_t uIdx) const
+    {
+        return mpData[uIdx];
+    }
+
+    // Getters.
+    iterator begin() const
+    {
+        return mpData;
+    }
+
+    iterator end() const
+    {
+        return mpData + muSize;
+    }
+
+    T* data() const
+    {
+        return mpData;
+    }
+
+    size_t size() const
+    {
+        return muSize;
+    }
+
+    bool empty() const
+    {
+        return (0 == muSize);
+    }
+
+private:
+    T* mpData; //!< First object in the view.
+    size_t muSize; //!< Number of objects in the view.
+};
+
+#endif // SPAN_H
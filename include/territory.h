@@ -0,0 +1,92 @@
+#ifndef TERRITORY_H
+#define TERRITORY_H
+
+#include <set>
+#include "include/cellstore.h"
+
+#if !defined(_TERRITORY_CONSTS)
+#define _TERRITORY_CONSTS
+#define TERRITORY_MAX_ARCS (NUM_HEX_VERTS / 2) //!< Most separate runs of same-colored neighbors a cell can have (every other neighbor).
+#endif // #if !defined(_TERRITORY_CONSTS)
+
+//! Kinds of territory changes reported by CTerritories.
+enum ETerritoryChange
+{
+    Territory_Merged, //!< Territories of a color were joined into one.
+    Territory_Split //!< A territory of a color was cut into pieces.
+};
+
+//! A single territory change, see CTerritories::GetEvents.
+struct STerritoryEvent
+{
+    ECellColors meColor; //!< Color whose territories changed.
+    ETerritoryChange meChange; //!< What happened.
+    u32 muCount; //!< Number of territories joined (merge) or number of pieces left (split).
+};
+
+/*!
+ * \brief The CTerritories class
+ *
+ * This class tracks the connected same-colored regions (territories) of a board. Every cell carries a territory label and labels are joined with union-find, so
+ * "which territory is this cell in", "how many territories does Blue have" and "how big is Blue's largest territory" are all answered without walking the board.
+ *
+ * A cell gaining a color joins the territories of it's new neighbors (a union per neighbor). A cell losing a color can only split it's old territory if the
+ * neighbors it leaves behind don't touch each other around it, and only then is a local search run: one breadth-first search per separate run of neighbors,
+ * stepped in lock-step, which stops as soon as they meet or all but one have run out. Whatever ran out is a new territory, so the cost is bounded by the
+ * smaller pieces rather than the whole board.
+ *
+ * \note Labels are never reused, so once they outnumber the cells by a wide margin everything is relabeled from scratch (see Build).
+ */
+class CTerritories
+{
+public:
+    CTerritories();
+    CTerritories(const CTerritories& aCls);
+    ~CTerritories();
+
+    CTerritories& operator=(const CTerritories& aCls);
+
+    // Workers.
+    void Build(CCellStore* pStore);
+    void Destroy();
+
+    void CellRecolored(u32 uCellIdx, ECellColors eOldClr, ECellColors eNewClr);
+    void ClearEvents();
+
+    // Getters.
+    u32 GetTerritory(u32 uCellIdx);
+    u32 GetTerritorySize(u32 uCellIdx);
+    bool SameTerritory(u32 uCellIdxA, u32 uCellIdxB);
+
+    u32 GetTerritoryCount(ECellColors eClr);
+    u32 GetLargestTerritory(ECellColors eClr);
+
+    const std::vector<STerritoryEvent>& GetEvents();
+
+private:
+    u32 NewLabel(u8 uClr, u32 uSize);
+    u32 FindRoot(u32 uLabel);
+    u32 Union(u32 uRootA, u32 uRootB);
+    void ResizeTerritory(u32 uRoot, u32 uNewSize);
+
+    void CellGained(u32 uCellIdx, u8 uClr);
+    void CellLost(u32 uCellIdx, u8 uClr);
+    u32 NextStamp();
+
+    CCellStore* mpStore; //!< Cell store of the board the territories are on.
+
+    std::vector<u32> mvCellLabels; //!< Territory label of every cell (by cell index), INVALID_CELL_IDX for holes.
+    std::vector<u32> mvLabelParent; //!< Union-find parent of every label, a label is a root if it's it's own parent.
+    std::vector<u32> mvLabelSize; //!< Number of cells in the territory (only meaningful for roots).
+    std::vector<u8> mvLabelColor; //!< Palette index of the territory's color.
+    std::vector<std::multiset<u32>> mvTerritorySizes; //!< Per palette color, the size of each of it's territories.
+    u32 muNumValidCells; //!< Number of cells on the board, used to decide when to relabel.
+
+    std::vector<u32> mvVisitStamps; //!< Per cell, the stamp of the last search to visit it (see NextStamp).
+    u32 muStamp; //!< Last stamp handed out.
+    std::vector<u32> mvSearchQueues[TERRITORY_MAX_ARCS]; //!< Scratch search queues used when a cell is lost, every cell ever queued stays in the queue.
+
+    std::vector<STerritoryEvent> mvEvents; //!< Merges and splits since the last ClearEvents.
+};
+
+#endif // TERRITORY_H
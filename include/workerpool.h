@@ -0,0 +1,49 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "include/globals.h"
+
+/*!
+ * \brief The CWorkerPool class
+ *
+ * This class keeps a fixed set of worker threads alive between batches of work, so work that's split over threads many times a second (e.g. an infection round
+ * per auto-play move) doesn't pay for starting and joining threads every time. A batch is a number of jobs handed to "Run", which runs them on the workers and the
+ * calling thread and returns once they're all done. Jobs of one batch must not depend on each other.
+ *
+ * \note Run isn't reentrant, a pool runs one batch at a time for the thread that owns it.
+ */
+class CWorkerPool
+{
+public:
+    explicit CWorkerPool(u32 uNumWorkers);
+    CWorkerPool(const CWorkerPool& aCls) = delete;
+    ~CWorkerPool();
+
+    CWorkerPool& operator=(const CWorkerPool& aCls) = delete;
+
+    // Workers.
+    void Run(u32 uNumJobs, const std::function<void(u32)>& fJob);
+
+    // Getters.
+    u32 GetNumWorkers();
+
+private:
+    void WorkerLoop();
+    bool RunNextJob(std::unique_lock<std::mutex>& lLock);
+
+    std::vector<std::thread> mvWorkers; //!< The worker threads, started by the constructor and joined by the destructor.
+    std::mutex mLock; //!< Guards everything below.
+    std::condition_variable mWorkReady; //!< Signalled when a batch starts (or the pool is shutting down).
+    std::condition_variable mWorkDone; //!< Signalled when the last job of a batch finishes.
+    const std::function<void(u32)>* mpJob; //!< Job of the current batch, nullptr between batches.
+    u32 muNumJobs; //!< Number of jobs in the current batch.
+    u32 muNextJob; //!< Next job of the batch nobody has taken yet.
+    u32 muJobsLeft; //!< Jobs of the batch that haven't finished yet.
+    bool mbQuit; //!< Set by the destructor to send the workers home.
+};
+
+#endif // WORKERPOOL_H
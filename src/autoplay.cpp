@@ -0,0 +1,291 @@
+#include "include/autoplay.h"
+
+// ================================ Begin CMovePolicy Implementation ================================ //
+CMovePolicy::~CMovePolicy()
+{
+    // Intentionally left blank.
+}
+
+/*!
+ * \brief CMovePolicy::Create
+ *
+ * This function makes a policy by name (case insensitive).
+ *
+ * \param sName - Name of the policy ("random" or "border").
+ * \return The new policy (the caller owns it), nullptr if there's no policy by that name.
+ */
+CMovePolicy* CMovePolicy::Create(const std::string& sName)
+{
+    const QString c_sName = QString::fromStdString(sName);
+    if (0 == c_sName.compare("random", Qt::CaseInsensitive))
+    {
+        return new CRandomPolicy();
+    }
+    else if (0 == c_sName.compare("border", Qt::CaseInsensitive))
+    {
+        return new CBorderPolicy();
+    }
+
+    return nullptr;
+}
+// ================================ End CMovePolicy Implementation ================================ //
+
+
+// ================================ Begin CRandomPolicy Implementation ================================ //
+const char* CRandomPolicy::GetName()
+{
+    return "random";
+}
+
+/*!
+ * \brief CRandomPolicy::PickMove
+ *
+ * This function picks a random live color to attack White, or a random other live color once White is gone.
+ *
+ * \return True if a move was picked, false if there aren't two live colors left.
+ */
+bool CRandomPolicy::PickMove(CBoard& aBoard, CDice& aDice, ECellColors& eAggressor, ECellColors& eVictim)
+{
+    ECellColors aLive[NUM_CELL_COLORS];
+    u32 uNumLive = 0;
+    for (u8 uClr = 1; NUM_CELL_COLORS > uClr; ++uClr)
+    {
+        if (0 < aBoard.GetColorCount(PaletteToColor(uClr))) { aLive[uNumLive++] = PaletteToColor(uClr); }
+    }
+
+    const bool c_bWhiteLeft = (0 < aBoard.GetColorCount(Cell_White));
+    if (0 == uNumLive || (1 == uNumLive && !c_bWhiteLeft)) { return false; }
+
+    const u32 c_uAggr = aDice.Roll(0, 0) % uNumLive;
+    eAggressor = aLive[c_uAggr];
+    if (c_bWhiteLeft)
+    {
+        eVictim = Cell_White;
+    }
+    else
+    {
+        // Any live color but the aggressor.
+        const u32 c_uVictim = (c_uAggr + 1 + aDice.Roll(0, 0) % (uNumLive - 1)) % uNumLive;
+        eVictim = aLive[c_uVictim];
+    }
+
+    return true;
+}
+// ================================ End CRandomPolicy Implementation ================================ //
+
+
+// ================================ Begin CBorderPolicy Implementation ================================ //
+const char* CBorderPolicy::GetName()
+{
+    return "border";
+}
+
+/*!
+ * \brief CBorderPolicy::PickMove
+ *
+ * This function picks a random live color that borders another color, and a color it borders as the victim. White goes first if it borders White. Otherwise the
+ * victim is the smallest other live color if it borders it, or else the bordering color with a frontier cell nearest to that smallest color (only the first
+ * AUTO_BORDER_SAMPLES frontier cells of each are looked at, ties are broken at random).
+ *
+ * \return True if a move was picked, false if no two colors border each other.
+ */
+bool CBorderPolicy::PickMove(CBoard& aBoard, CDice& aDice, ECellColors& eAggressor, ECellColors& eVictim)
+{
+    ECellColors aLive[NUM_CELL_COLORS];
+    u32 uNumLive = 0;
+    for (u8 uClr = 1; NUM_CELL_COLORS > uClr; ++uClr)
+    {
+        if (0 < aBoard.GetColorCount(PaletteToColor(uClr))) { aLive[uNumLive++] = PaletteToColor(uClr); }
+    }
+
+    if (0 == uNumLive) { return false; }
+
+    // Go round the live colors from a random one until one of them borders someone.
+    const u32 c_uFirst = aDice.Roll(0, 0) % uNumLive;
+    for (u32 uOffset = 0; uNumLive > uOffset; ++uOffset)
+    {
+        const ECellColors eAggr = aLive[(c_uFirst + uOffset) % uNumLive];
+        if (aBoard.NationsBorder(eAggr, Cell_White))
+        {
+            eAggressor = eAggr;
+            eVictim = Cell_White;
+            return true;
+        }
+
+        // The prey is the smallest color left.
+        ECellColors ePrey = Comb_Mixed;
+        ECellColors aTargets[NUM_CELL_COLORS];
+        u32 uNumTargets = 0;
+        for (u32 uLive = 0; uNumLive > uLive; ++uLive)
+        {
+            if (eAggr == aLive[uLive]) { continue; }
+            if (Comb_Mixed == ePrey || aBoard.GetColorCount(ePrey) > aBoard.GetColorCount(aLive[uLive])) { ePrey = aLive[uLive]; }
+            if (aBoard.NationsBorder(eAggr, aLive[uLive])) { aTargets[uNumTargets++] = aLive[uLive]; }
+        }
+
+        if (0 == uNumTargets) { continue; }
+
+        eAggressor = eAggr;
+        if (aBoard.NationsBorder(eAggr, ePrey))
+        {
+            eVictim = ePrey;
+            return true;
+        }
+
+        // Push through the neighbor that gets closest to the prey.
+        CDistanceFields* pDistances = aBoard.GetDistanceFields();
+        const u32 c_uFirstTarget = aDice.Roll(0, 0) % uNumTargets;
+        u32 uBestDist = DISTANCE_UNREACHED;
+        eVictim = aTargets[c_uFirstTarget];
+        for (u32 uTarget = 0; uNumTargets > uTarget; ++uTarget)
+        {
+            const ECellColors eTarget = aTargets[(c_uFirstTarget + uTarget) % uNumTargets];
+            u32 uNumSamples = 0;
+            for (u32 uCellIdx : aBoard.GetFrontier(eAggr, eTarget))
+            {
+                const u32 c_uDist = pDistances->GetDistance(ePrey, uCellIdx);
+                if (uBestDist > c_uDist)
+                {
+                    uBestDist = c_uDist;
+                    eVictim = eTarget;
+                }
+
+                if (AUTO_BORDER_SAMPLES <= ++uNumSamples) { break; }
+            }
+        }
+
+        return true;
+    }
+
+    return false;
+}
+// ================================ End CBorderPolicy Implementation ================================ //
+
+
+// ================================ Begin CAutoPlayer Implementation ================================ //
+CAutoPlayer::CAutoPlayer() : mpPolicy{nullptr}, muMovesPerSec{AUTO_DEFAULT_RATE}, muMovesDue{0}, muNumMoves{0}, mbRunning{false}, mbDirty{false}
+{
+    // Intentionally left blank.
+}
+
+CAutoPlayer::~CAutoPlayer()
+{
+    Stop();
+    if (nullptr != mpPolicy) { delete mpPolicy; }
+}
+
+/*!
+ * \brief CAutoPlayer::Start
+ *
+ * This method starts (or restarts) auto-play.
+ *
+ * \param uMovesPerSec - Moves to make per second, clamped to [1 - AUTO_MAX_RATE].
+ * \param pPolicy - Policy to pick the moves with, auto-play takes ownership of it. nullptr keeps the current policy (or picks "random" if there isn't one).
+ */
+void CAutoPlayer::Start(u32 uMovesPerSec, CMovePolicy* pPolicy)
+{
+    if (nullptr != pPolicy)
+    {
+        if (nullptr != mpPolicy) { delete mpPolicy; }
+        mpPolicy = pPolicy;
+    }
+    else if (nullptr == mpPolicy)
+    {
+        mpPolicy = new CRandomPolicy();
+    }
+
+    muMovesPerSec = std::max(1u, std::min(uMovesPerSec, static_cast<u32>(AUTO_MAX_RATE)));
+    muMovesDue = 0;
+    muNumMoves = 0;
+    mbRunning = true;
+    mbDirty = false;
+    mtStart = std::chrono::steady_clock::now();
+    mtLastFrame = mtStart;
+}
+
+/*!
+ * \brief CAutoPlayer::Stop
+ *
+ * This method stops auto-play, the policy is kept for the next start.
+ */
+void CAutoPlayer::Stop()
+{
+    mbRunning = false;
+}
+
+/*!
+ * \brief CAutoPlayer::TakeDueMoves
+ *
+ * This function returns how many moves have to be made now to keep to the rate, and counts them as made. If the moves have fallen more than AUTO_MAX_BACKLOG_MS
+ * behind, the rest of the backlog is dropped so a slow board never ties the event loop up catching up.
+ *
+ * \return Number of moves to make.
+ */
+u32 CAutoPlayer::TakeDueMoves()
+{
+    if (!mbRunning) { return 0; }
+
+    const double c_nElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - mtStart).count();
+    const u64 c_uTarget = static_cast<u64>(c_nElapsed * muMovesPerSec);
+    const u64 c_uMaxBacklog = std::max<u64>(1, static_cast<u64>(muMovesPerSec) * AUTO_MAX_BACKLOG_MS / 1000);
+
+    if (c_uTarget > muMovesDue + c_uMaxBacklog) { muMovesDue = c_uTarget - c_uMaxBacklog; }
+
+    const u32 c_uDue = static_cast<u32>(c_uTarget - std::min(c_uTarget, muMovesDue));
+    muMovesDue += c_uDue;
+    muNumMoves += c_uDue;
+    mbDirty |= (0 < c_uDue);
+
+    return c_uDue;
+}
+
+/*!
+ * \brief CAutoPlayer::TakeFrame
+ *
+ * This function says if it's time to redraw and update the clients: moves were made since the last frame and the last one was at least AUTO_FRAME_MS ago.
+ *
+ * \return True if a frame is due (and counts it as done), false otherwise.
+ */
+bool CAutoPlayer::TakeFrame()
+{
+    const std::chrono::steady_clock::time_point c_tNow = std::chrono::steady_clock::now();
+    if (!mbDirty || std::chrono::milliseconds(AUTO_FRAME_MS) > (c_tNow - mtLastFrame)) { return false; }
+
+    mbDirty = false;
+    mtLastFrame = c_tNow;
+
+    return true;
+}
+
+/*!
+ * \brief CAutoPlayer::PickMove
+ *
+ * This function picks the next move with the current policy.
+ *
+ * \return True if a move was picked, false if there's no policy or no move left to make.
+ */
+bool CAutoPlayer::PickMove(CBoard& aBoard, CDice& aDice, ECellColors& eAggressor, ECellColors& eVictim)
+{
+    return (nullptr != mpPolicy) ? mpPolicy->PickMove(aBoard, aDice, eAggressor, eVictim) : false;
+}
+
+bool CAutoPlayer::IsRunning()
+{
+    return mbRunning;
+}
+
+u32 CAutoPlayer::GetRate()
+{
+    return muMovesPerSec;
+}
+
+u64 CAutoPlayer::GetNumMoves()
+{
+    return muNumMoves;
+}
+
+const char* CAutoPlayer::GetPolicyName()
+{
+    return (nullptr != mpPolicy) ? mpPolicy->GetName() : "none";
+}
+// ================================ End CAutoPlayer Implementation ================================ //
@@ -1,245 +1,545 @@
+#include <QtAlgorithms>
+#include <thread>
 #include "include/board.h"
+#include "include/workerpool.h"
+
+/*!
+ * \brief FrontierSlot
+ *
+ * Maps an (aggressor, victim) color pair to it's slot in the board's frontier tables. Anything that isn't a real cell color maps past the end.
+ */
+static inline u32 FrontierSlot(ECellColors eAggressor, ECellColors eVictim)
+{
+    const u8 c_uAggr = ColorToPalette(eAggressor);
+    const u8 c_uVictim = ColorToPalette(eVictim);
+    if (NUM_CELL_COLORS <= c_uAggr || NUM_CELL_COLORS <= c_uVictim) { return NUM_CELL_COLORS * NUM_CELL_COLORS; }
+
+    return static_cast<u32>(c_uAggr) * NUM_CELL_COLORS + c_uVictim;
+}
 
 // FOR DEBUGGING ONLY!
 QPointF l_CollisionPoints[NUM_HEX_VERTS];
 
-CBoard::CBoard() : miSize{2}, mnCombSz{0}
+CBoard::CBoard() : miSize{2}, mnCombSz{0}, mnCellRadius{0}, mCenter{SPoint(0, 0)}, msTemplateDir{""}, muMaxThreads{0}, mpInfectPool{nullptr}, mbHeadless{false}, muNumValidCells{0}
 {
     // Intentionally left blank.
 }
 
-CBoard::CBoard(const CBoard& aCls) : miSize{aCls.miSize}, mnCombSz{aCls.mnCombSz}
+CBoard::~CBoard()
+{
+    Destroy();
+    if (nullptr != mpInfectPool) { delete mpInfectPool; }
+}
+
+/*!
+ * \brief CBoard::Create
+ *
+ * This method is used to "create" a new board. The board geometry only depends on the board size, cell size and center, so if a template for those was cached
+ * before it's mapped straight in. Otherwise the honeycombs are allocated out of the comb arena and tessellated, and the result is cached for next time.
+ *
+ * \param uCellSz - This is the size of the cells for the combs.
+ * \param aqCenter - The center of the board.
+ */
+void CBoard::Create(u32 uCellSz, SPoint aqCenter)
 {
-    if (!aCls.mpBoardCombs.empty())
+    const u32 c_uCellRadius = uCellSz / 2;
+
+    mnCombSz = static_cast<float>(c_uCellRadius * CELL_COMB_RATIO);
+    mnCellRadius = static_cast<float>(uCellSz) / 2.0f;
+    mCenter = aqCenter;
+
+    const QString sTemplatePath = GetTemplatePath(uCellSz);
+    if (sTemplatePath.isEmpty() || !LoadTemplate(sTemplatePath, uCellSz))
     {
-        mpBoardCombs = aCls.mpBoardCombs;
-        mColorLastMap = aCls.mColorLastMap;
-        mvNations = aCls.mvNations;
+        GenerateBoard(uCellSz);
+
+        if (!sTemplatePath.isEmpty()) { SaveTemplate(sTemplatePath); }
     }
+
+    // Hand the cells to their starting nations.
+    BuildNations();
+    PublishSnapshot();
 }
 
-CBoard::~CBoard()
+/*!
+ * \brief CBoard::GenerateBoard
+ *
+ * This method tessellates the honeycombs for the current board size, lays the cell store over them and builds the neighbor graph.
+ *
+ * \param uCellSz - This is the size of the cells for the combs.
+ */
+void CBoard::GenerateBoard(u32 uCellSz)
 {
-    for (CombIterator pIter = mpBoardCombs.begin(); pIter != mpBoardCombs.end(); ++pIter)
+    // Every layer "n" is the ring of 6*n combs "n" steps out on the honeycomb super-lattice, so the layers are a single spiral walk over it.
+    const CHexSpiral lLayers(SHexCoord(0, 0), miSize, c_iCombStepQ, c_iCombStepR);
+    mpBoardCombs.reserve(lLayers.size());
+    mCombArena.Reserve(lLayers.size());
+    if (!mbHeadless) { qInfo("Positioning %u honeycombs...", lLayers.size()); }
+
+    u8 uClr = ColorToPalette(Cell_White);
+    for (CHexSpiral::CIterator pCoordIter = lLayers.begin(); pCoordIter != lLayers.end(); ++pCoordIter)
     {
-        CHoneyComb *pTmp = (*pIter);
-        if (nullptr != pTmp)
+        // The outer-most layer is split between the playing colors, everything else starts out white.
+        if (0 < pCoordIter.GetRadius() && miSize == pCoordIter.GetRadius())
         {
-            delete pTmp;
+            ++uClr;
+            if (NUM_CELL_COLORS <= uClr) { uClr = ColorToPalette(Cell_Red); }
         }
+
+        CHoneyComb* pTmpComb = mCombArena.Alloc();
+        pTmpComb->SetCellSize(uCellSz);
+        pTmpComb->SetCoord((*pCoordIter));
+        pTmpComb->SetPosition(CoordToPixel((*pCoordIter)));
+        pTmpComb->SetCombColor(PaletteToColor(uClr));
+        mpBoardCombs.push_back(pTmpComb);
     }
 
-    for (std::vector<CNation*>::iterator pNatIter = mvNations.end(); pNatIter != mvNations.begin(); --pNatIter)
+    // Find the lattice bounds so every coordinate maps straight onto a cell index. Outer cells are one step from their comb's center in each axis.
+    SHexCoord lMin(0, 0);
+    SHexCoord lMax(0, 0);
+    for (CombIterator pIter = mpBoardCombs.begin(); pIter != mpBoardCombs.end(); ++pIter)
     {
-        CNation *pTmp = (*pNatIter);
-        if (nullptr != pTmp)
-        {
-            delete pTmp;
-        }
+        const SHexCoord& lCoord = (*pIter)->GetCoord();
+        lMin = SHexCoord(std::min(lMin.mQ, lCoord.mQ - 1), std::min(lMin.mR, lCoord.mR - 1));
+        lMax = SHexCoord(std::max(lMax.mQ, lCoord.mQ + 1), std::max(lMax.mR, lCoord.mR + 1));
     }
 
-    mvNations.clear();
+    // Size the cell store and mark the cells of every comb, this allocates the tiles the board actually covers.
+    mCellStore.Create(lMin, static_cast<u32>(lMax.mQ - lMin.mQ + 1), static_cast<u32>(lMax.mR - lMin.mR + 1), static_cast<float>(uCellSz));
+    for (CombIterator pIter = mpBoardCombs.begin(); pIter != mpBoardCombs.end(); ++pIter)
+    {
+        mCellStore.SetValid(mCellStore.CoordToIndex((*pIter)->GetCoord()));
+        for (u32 uDir = 0; NUM_HEX_VERTS > uDir; ++uDir) { mCellStore.SetValid(mCellStore.CoordToIndex((*pIter)->GetCoord().Neighbor(uDir))); }
+    }
+
+    // Lay the cell views over the store and hand each comb it's cells.
+    BuildCellViews();
+    AttachCombCells(true);
+
+    // Now that every cell is placed, build the neighbor graph once.
+    BuildAdjacency();
 }
 
-CBoard& CBoard::operator =(const CBoard& aCls)
+/*!
+ * \brief CBoard::BuildCellViews
+ *
+ * This method creates a cell view for every index of every allocated tile of the cell store. Views are tiled the same way as the store, so the empty parts of
+ * the bounding box don't get views either.
+ */
+void CBoard::BuildCellViews()
 {
-    if (this != &aCls)
+    mvCellTiles.assign(mCellStore.GetNumTiles(), std::vector<CCell>());
+    for (u32 uTile = 0; mCellStore.GetNumTiles() > uTile; ++uTile)
     {
-        miSize = aCls.miSize;
-        mnCombSz = aCls.mnCombSz;
+        if (nullptr == mCellStore.GetTile(uTile)) { continue; }
 
-        mpBoardCombs = aCls.mpBoardCombs;
-        mColorLastMap = aCls.mColorLastMap;
-        mvNations = aCls.mvNations;
+        std::vector<CCell>& vViews = mvCellTiles[uTile];
+        vViews.reserve(CELL_TILE_SZ);
+        for (u32 uSlot = 0; CELL_TILE_SZ > uSlot; ++uSlot) { vViews.push_back(CCell(&mCellStore, (uTile << CELL_TILE_SHIFT) | uSlot)); }
     }
+}
+
+/*!
+ * \brief CBoard::AttachCombCells
+ *
+ * This method hands each honeycomb the views of it's cells (center first, then the neighbors in direction order), and records the comb of each cell in the store.
+ *
+ * \param bPlaceCells - True to also position the cells and give them their comb's color. False if the cell store already holds all of that.
+ */
+void CBoard::AttachCombCells(bool bPlaceCells)
+{
+    std::vector<CCell*> vCells;
+    vCells.reserve(NUM_HEX_VERTS+1);
+
+    for (CombIterator pIter = mpBoardCombs.begin(); pIter != mpBoardCombs.end(); ++pIter)
+    {
+        CHoneyComb* pComb = (*pIter);
+
+        vCells.clear();
+        for (u32 uCell = 0; (NUM_HEX_VERTS+1) > uCell; ++uCell)
+        {
+            const SHexCoord lCoord = (0 == uCell) ? pComb->GetCoord() : pComb->GetCoord().Neighbor(uCell - 1);
+            const u32 uCellIdx = mCellStore.CoordToIndex(lCoord);
+
+            vCells.push_back(GetCell(uCellIdx));
+            mCellStore.SetComb(uCellIdx, static_cast<u32>(pIter - mpBoardCombs.begin()));
+        }
+
+        // Color the cells before handing them over, the comb counts it's colors when it gets them.
+        if (bPlaceCells)
+        {
+            for (std::vector<CCell*>::iterator iCellIter = vCells.begin(); iCellIter != vCells.end(); ++iCellIter)
+            {
+                AddCell((*iCellIter), pComb->GetCombColor());
+            }
+        }
 
-    return *this;
+        pComb->SetCells(vCells, bPlaceCells);
+    }
 }
 
 /*!
- * \brief CBoard::Create
+ * \brief CBoard::BuildNations
  *
- * This method is used to "create" a new board. This invloves heap-allocating (if needed) new honeycombs and tessellating them accordingly.
+ * This method creates the starting nations from the cell colors, handing each nation all of it's cells in one go. The per-color cell counts and territories are
+ * taken here too, and the distance fields are reset (they're computed when first asked for).
+ */
+void CBoard::BuildNations()
+{
+    BuildColorCells();
+
+    muNumValidCells = 0;
+    for (u8 uClr = 0; NUM_CELL_COLORS > uClr; ++uClr)
+    {
+        muNumValidCells += mvColorCounts[uClr];
+        if (0 < mvColorCounts[uClr]) { AddCellsToNation(PaletteToColor(uClr), mvColorCells[uClr]); }
+    }
+
+    BuildFrontiers();
+
+    if (!mbHeadless)
+    {
+        mTerritories.Build(&mCellStore);
+        mTerritories.ClearEvents();
+    }
+    mDistances.Build(&mCellStore);
+}
+
+/*!
+ * \brief CBoard::Destroy
  *
- * \param uCellSz - This is the size of the cells for the combs.
- * \param aqCenter - The center of the board.
+ * This method is used to "destroy" an existing board. The combs and nations live in the board's arenas and the cells live in the board's cell store, so everything
+ * is released in one go without visiting objects one at a time. The memory itself is kept so the next "Create" doesn't need to allocate again.
  */
-void CBoard::Create(u32 uCellSz, SPoint aqCenter)
+void CBoard::Destroy()
 {
-    const u32 c_uCellRadius = uCellSz / 2;
-    const float c_nCombSize = static_cast<float>(c_uCellRadius * CELL_COMB_RATIO);
-    float nTessSz = (c_nCombSize * TESS_COMBSZ_TO_TESSSZ);
+    // Drop the nations and combs, the arenas keep their storage for the next board.
+    mvNations.clear();
+    mNationArena.Reset();
+
+    mpBoardCombs.clear();
+    mCombArena.Reset();
 
-    // Explicitly set the center comb.
-    SPoint qStartPos = aqCenter;
+    // Clear the color last map.
+    mColorLastMap.clear();
 
-    CHoneyComb* pTmpComb = new CHoneyComb();
-    pTmpComb->SetCellSize(uCellSz);
-    pTmpComb->SetPosition(qStartPos);
-    mpBoardCombs.push_back(pTmpComb);
+    // Clear the cells (the views first, then the store they look into) and the neighbor graph.
+    mvCellTiles.clear();
+    mCellStore.Destroy();
+    mvDirShifts.clear();
+    mvDirMasks.clear();
+    mvColorCells.clear();
+    mvFrontiers.clear();
+    mvFrontierSizes.clear();
+    mvColorCounts.clear();
+    muNumValidCells = 0;
+    mTerritories.Destroy();
+    mDistances.Destroy();
+    std::atomic_store(&mpSnapshot, std::shared_ptr<const CCellSnapshot>());
+}
 
-    // Add the new cells to the cell map.
-    std::vector<CCell*> vCells = pTmpComb->GetCells();
-    for (std::vector<CCell*>::iterator iCellIter = vCells.begin(); iCellIter != vCells.end(); ++iCellIter)
+/*!
+ * \brief CBoard::SaveTemplate
+ *
+ * This method writes the current board geometry (combs, cell store and neighbor graph) out as a board template, see SBoardTemplateHeader for the layout. The
+ * template is written to a temporary file first and then moved into place, so a half-written template is never picked up by another board.
+ *
+ * \param sPath - Path of the template file.
+ * \return True if the template was written, false otherwise.
+ */
+bool CBoard::SaveTemplate(const QString& sPath)
+{
+    const u32 c_uNumCells = mCellStore.GetCount();
+    if (0 == c_uNumCells)
     {
-        CCell* pCell = (*iCellIter);
+        return false;
+    }
 
-        if (nullptr != pCell)
-        {
-            const SPoint lCellPos = pCell->GetPosition();
+    SBoardTemplateHeader lHeader;
+    lHeader.uMagic = BOARD_TEMPLATE_MAGIC;
+    lHeader.uVersion = BOARD_TEMPLATE_VERSION;
+    lHeader.uCellSz = static_cast<u32>(mCellStore.GetCellSize());
+    lHeader.uBoardSize = miSize;
+    lHeader.nCenterX = mCenter.mX;
+    lHeader.nCenterY = mCenter.mY;
+    lHeader.iMinQ = IndexToCoord(0).mQ;
+    lHeader.iMinR = IndexToCoord(0).mR;
+    lHeader.uSpanQ = mCellStore.GetSpanQ();
+    lHeader.uSpanR = mCellStore.GetSpanR();
+    lHeader.uNumCombs = static_cast<u32>(mpBoardCombs.size());
+    lHeader.uNumTiles = mCellStore.GetNumTiles();
+
+    std::vector<SBoardTemplateComb> vCombs;
+    vCombs.reserve(mpBoardCombs.size());
+    for (CombIterator pIter = mpBoardCombs.begin(); pIter != mpBoardCombs.end(); ++pIter)
+    {
+        SBoardTemplateComb lComb;
+        lComb.iQ = (*pIter)->GetCoord().mQ;
+        lComb.iR = (*pIter)->GetCoord().mR;
+        lComb.uColor = static_cast<u32>((*pIter)->GetCombColor());
+        vCombs.push_back(lComb);
+    }
 
-            u64 uCellID = static_cast<u32>(lCellPos.mX);
-            uCellID = uCellID << (WORD_SZ / 2);
-            uCellID += static_cast<u32>(lCellPos.mY);
+    std::vector<u8> vTilePresent((static_cast<size_t>(lHeader.uNumTiles) + BOARD_TEMPLATE_ALIGN - 1) & ~static_cast<size_t>(BOARD_TEMPLATE_ALIGN - 1), 0);
+    for (u32 uTile = 0; lHeader.uNumTiles > uTile; ++uTile) { vTilePresent[uTile] = (nullptr != mCellStore.GetTile(uTile)) ? 1 : 0; }
 
-            // Add the cell to the map.
-            mmCellMap.insert(std::pair<u64, CCell*>(uCellID, pCell));
+    QFile lFile(sPath + ".tmp");
+    if (!lFile.open(QIODevice::WriteOnly))
+    {
+        if (!mbHeadless) { qWarning("Unable to write board template \"%s\"!", sPath.toStdString().c_str()); }
+        return false;
+    }
 
-            // Add the cell ID to the correct nation.
-            AddCellToNation(Cell_White, uCellID);
+    bool bSuccess = true;
+    bSuccess = bSuccess && (sizeof(lHeader) == lFile.write(reinterpret_cast<const char*>(&lHeader), sizeof(lHeader)));
+    bSuccess = bSuccess && (qint64(sizeof(SBoardTemplateComb) * vCombs.size()) == lFile.write(reinterpret_cast<const char*>(vCombs.data()), sizeof(SBoardTemplateComb) * vCombs.size()));
+    bSuccess = bSuccess && (qint64(vTilePresent.size()) == lFile.write(reinterpret_cast<const char*>(vTilePresent.data()), vTilePresent.size()));
+    for (u32 uTile = 0; bSuccess && lHeader.uNumTiles > uTile; ++uTile)
+    {
+        const SCellTile* pTile = mCellStore.GetTile(uTile);
+        if (nullptr == pTile) { continue; }
 
-            // Set the cell's color.
-            pCell->SetColor(Cell_White);
-        }
+        bSuccess = bSuccess && (qint64(sizeof(pTile->mnCenterX)) == lFile.write(reinterpret_cast<const char*>(pTile->mnCenterX), sizeof(pTile->mnCenterX)));
+        bSuccess = bSuccess && (qint64(sizeof(pTile->mnCenterY)) == lFile.write(reinterpret_cast<const char*>(pTile->mnCenterY), sizeof(pTile->mnCenterY)));
+        bSuccess = bSuccess && (qint64(sizeof(pTile->muColor)) == lFile.write(reinterpret_cast<const char*>(pTile->muColor), sizeof(pTile->muColor)));
+        bSuccess = bSuccess && (qint64(sizeof(pTile->muValid)) == lFile.write(reinterpret_cast<const char*>(pTile->muValid), sizeof(pTile->muValid)));
     }
+    lFile.close();
 
-    if (miSize > 0)
+    if (bSuccess)
     {
-        // Set the starting position of the first layer.
-        float nX = qStartPos.x() + (nTessSz * TESS_X_SHIFT);
-        float nY = qStartPos.y() - (nTessSz * TESS_Y_SHIFT);
+        QFile::remove(sPath);
+        bSuccess = lFile.rename(sPath);
+    }
 
-        qStartPos.setX(nX);
-        qStartPos.setY(nY);
+    if (bSuccess)
+    {
+        if (!mbHeadless) { qInfo("Cached board template \"%s\".", sPath.toStdString().c_str()); }
+    }
+    else
+    {
+        lFile.remove();
+        if (!mbHeadless) { qWarning("Unable to write board template \"%s\"!", sPath.toStdString().c_str()); }
+    }
 
-        u32 eClr = static_cast<u32>(Cell_White);
+    return bSuccess;
+}
 
-        // Iterate over the layers, adding the appropriate number of combs.
-        for (u32 iLyrIdx = 0; iLyrIdx < miSize; ++iLyrIdx)
-        {
-            // Add the new combs.
-            std::vector<SPoint> vLayerPos = CalcTessPos(qStartPos, iLyrIdx, uCellSz, nTessSz);
+/*!
+ * \brief CBoard::LoadTemplate
+ *
+ * This method maps a board template written by "SaveTemplate" into memory and builds the board straight from it, skipping tessellation.
+ * The template has to match the current board size, the given cell size and the board center, and is fully checked before anything on the board is touched.
+ *
+ * \param sPath - Path of the template file.
+ * \param uCellSz - This is the size of the cells for the combs.
+ * \return True if the board was loaded, false if there's no (usable) template.
+ */
+bool CBoard::LoadTemplate(const QString& sPath, u32 uCellSz)
+{
+    QFile lFile(sPath);
+    if (!lFile.exists() || !lFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
 
-            qInfo("Positioning %lu honeycombs...", vLayerPos.size());
-            for (std::vector<SPoint>::iterator pPtIter = vLayerPos.begin(); pPtIter != vLayerPos.end(); ++pPtIter)
-            {
-                if ((miSize-1) == iLyrIdx)
-                {
-                    ++eClr;
-                    if (static_cast<u32>(Cell_Gray) < eClr) { eClr = static_cast<u32>(Cell_Red); }
-                }
+    const qint64 c_iFileSz = lFile.size();
+    const uchar* pData = (static_cast<qint64>(sizeof(SBoardTemplateHeader)) <= c_iFileSz) ? lFile.map(0, c_iFileSz) : nullptr;
+    if (nullptr == pData)
+    {
+        lFile.close();
+        return false;
+    }
 
-                ECellColors eColor = static_cast<ECellColors>(eClr);
+    const SBoardTemplateHeader* pHeader = reinterpret_cast<const SBoardTemplateHeader*>(pData);
+    const u64 c_uNumCells = static_cast<u64>(pHeader->uSpanQ) * pHeader->uSpanR;
+    const u64 c_uTileSz = (sizeof(float) * 2 + sizeof(u8) * 2) * CELL_TILE_SZ;
+    const u64 c_uPresentSz = (static_cast<u64>(pHeader->uNumTiles) + BOARD_TEMPLATE_ALIGN - 1) & ~static_cast<u64>(BOARD_TEMPLATE_ALIGN - 1);
+    const u64 c_uHeadSz = sizeof(SBoardTemplateHeader) + (sizeof(SBoardTemplateComb) * static_cast<u64>(pHeader->uNumCombs)) + c_uPresentSz;
 
-                CHoneyComb* pTmpComb = new CHoneyComb();
-                pTmpComb->SetCellSize(uCellSz);
-                pTmpComb->SetPosition((*pPtIter));
-                mpBoardCombs.push_back(pTmpComb);
+    bool bSuccess = (BOARD_TEMPLATE_MAGIC == pHeader->uMagic && BOARD_TEMPLATE_VERSION == pHeader->uVersion && uCellSz == pHeader->uCellSz &&
+                     miSize == pHeader->uBoardSize && mCenter.mX == pHeader->nCenterX && mCenter.mY == pHeader->nCenterY && 0 < c_uNumCells &&
+                     INVALID_CELL_IDX > c_uNumCells && ((c_uNumCells + CELL_TILE_SZ - 1) >> CELL_TILE_SHIFT) == pHeader->uNumTiles &&
+                     static_cast<u64>(c_iFileSz) >= c_uHeadSz);
 
-                // Add the new cells to the cell map.
-                std::vector<CCell*> vCells = pTmpComb->GetCells();
-                for (std::vector<CCell*>::iterator iCellIter = vCells.begin(); iCellIter != vCells.end(); ++iCellIter)
-                {
-                    CCell* pCell = (*iCellIter);
+    // Find the arrays following the header, then make sure the file holds exactly the tiles it says it does.
+    const SBoardTemplateComb* pCombs = reinterpret_cast<const SBoardTemplateComb*>(pData + sizeof(SBoardTemplateHeader));
+    const u8* pTilePresent = reinterpret_cast<const u8*>(pCombs + pHeader->uNumCombs);
+    const uchar* pTiles = pData + c_uHeadSz;
 
-                    if (nullptr != pCell)
-                    {
-                        const SPoint lCellPos = pCell->GetPosition();
+    if (bSuccess)
+    {
+        const u64 c_uNumPresent = static_cast<u64>(std::count_if(pTilePresent, pTilePresent + pHeader->uNumTiles, [](u8 uPresent) { return 0 != uPresent; }));
+        bSuccess = (static_cast<u64>(c_iFileSz) == c_uHeadSz + c_uNumPresent * c_uTileSz);
+    }
+
+    if (bSuccess)
+    {
+        const SHexCoord lMin(pHeader->iMinQ, pHeader->iMinR);
 
-                        u64 uCellID = static_cast<u32>(lCellPos.mX);
-                        uCellID = uCellID << (WORD_SZ / 2);
-                        uCellID += static_cast<u32>(lCellPos.mY);
+        // Lay the cell store over the template, tile by tile.
+        mCellStore.Create(lMin, pHeader->uSpanQ, pHeader->uSpanR, static_cast<float>(uCellSz));
+        for (u32 uTile = 0; pHeader->uNumTiles > uTile; ++uTile)
+        {
+            if (0 == pTilePresent[uTile]) { continue; }
 
-                        // Add the cell to the map.
-                        mmCellMap.insert(std::pair<u64, CCell*>(uCellID, pCell));
+            const float* pCentersX = reinterpret_cast<const float*>(pTiles);
+            const float* pCentersY = pCentersX + CELL_TILE_SZ;
+            const u8* pColors = reinterpret_cast<const u8*>(pCentersY + CELL_TILE_SZ);
+            const u8* pValidity = pColors + CELL_TILE_SZ;
+            mCellStore.AssignTile(uTile, pCentersX, pCentersY, pColors, pValidity);
 
-                        // Add the cell ID to the correct nation.
-                        AddCellToNation(eColor, uCellID);
+            pTiles += c_uTileSz;
+        }
 
-                        // Set the cell's color.
-                        pCell->SetColor(eColor);
-                    }
-                }
-            }
+        BuildCellViews();
 
-            // Update the starting position.
-            nX = qStartPos.x() + (nTessSz * TESS_X_SHIFT);
-            nY = qStartPos.y() - (nTessSz * TESS_Y_SHIFT);
+        // Rebuild the combs, every comb cell has to be a valid cell of the template.
+        mpBoardCombs.reserve(pHeader->uNumCombs);
+        mCombArena.Reserve(pHeader->uNumCombs);
+        for (u32 uIdx = 0; bSuccess && pHeader->uNumCombs > uIdx; ++uIdx)
+        {
+            const SHexCoord lCoord(pCombs[uIdx].iQ, pCombs[uIdx].iR);
+            for (u32 uDir = 0; bSuccess && NUM_HEX_VERTS > uDir; ++uDir) { bSuccess = (INVALID_CELL_IDX != CoordToIndex(lCoord.Neighbor(uDir))); }
+            bSuccess = bSuccess && (INVALID_CELL_IDX != CoordToIndex(lCoord));
+            bSuccess = bSuccess && (PALETTE_NONE != ColorToPalette(static_cast<ECellColors>(pCombs[uIdx].uColor)));
 
-            // Update the tessellation size.
-            nTessSz = (nTessSz * TESS_NEAR_TO_FAR);
+            if (bSuccess)
+            {
+                CHoneyComb* pTmpComb = mCombArena.Alloc();
+                pTmpComb->SetCellSize(uCellSz);
+                pTmpComb->SetCoord(lCoord);
+                pTmpComb->SetPosition(CoordToPixel(lCoord));
+                pTmpComb->SetCombColor(static_cast<ECellColors>(pCombs[uIdx].uColor));
+                mpBoardCombs.push_back(pTmpComb);
+            }
+        }
 
-            qStartPos.setX(nX);
-            qStartPos.setY(nY);
+        if (bSuccess)
+        {
+            AttachCombCells(false);
+            BuildAdjacency();
+        }
+        else
+        {
+            Destroy();
         }
     }
+
+    lFile.unmap(const_cast<uchar*>(pData));
+    lFile.close();
+
+    if (bSuccess)
+    {
+        if (!mbHeadless) { qInfo("Loaded board template \"%s\" (%u honeycombs).", sPath.toStdString().c_str(), static_cast<u32>(mpBoardCombs.size())); }
+    }
+    else
+    {
+        if (!mbHeadless) { qWarning("Ignoring stale or damaged board template \"%s\".", sPath.toStdString().c_str()); }
+    }
+
+    return bSuccess;
 }
 
 /*!
- * \brief CBoard::Destroy
+ * \brief CBoard::LoadColors
+ *
+ * This function recolors the whole board to match a snapshot of a board with the same layout (e.g. another board made from the same template). The colors are
+ * written straight into the cell store, then the nations and everything else kept off the colors (counts, contested sets, territories, distance fields) are
+ * rebuilt once from the per-color cell sets. When most of the board differs that's far cheaper than going through SetCellColor cell by cell.
  *
- * This method is used to "destroy" an existing board. This involves going through and deleting the individual combs in the comb array, not the array itself!
+ * \note Cells of a color that has no nation on this board are left unowned, no nations are created here.
+ *
+ * \param aSnapshot - Cell state to copy.
+ * \return True if the board was recolored, false if the snapshot is of a different layout.
  */
-void CBoard::Destroy()
+bool CBoard::LoadColors(const CCellSnapshot& aSnapshot)
 {
-    // Clear out the cells.
-    for (std::map<u64, CCell*>::iterator iCellIter = mmCellMap.begin(); iCellIter != mmCellMap.end(); ++iCellIter)
+    if (mpBoardCombs.empty() || aSnapshot.GetCount() != mCellStore.GetCount() || aSnapshot.GetNumTiles() != mCellStore.GetNumTiles()) { return false; }
+
+    for (u32 uTile = 0; aSnapshot.GetNumTiles() > uTile; ++uTile)
     {
-        std::pair<u64, CCell*> lCell = (*iCellIter);
-        if (nullptr != lCell.second)
+        const SCellTile* pTile = aSnapshot.GetTile(uTile);
+        const SCellTile* pOwnTile = mCellStore.GetTile(uTile);
+        if (nullptr == pTile || nullptr == pOwnTile) { continue; }
+
+        for (u32 uSlot = 0; CELL_TILE_SZ > uSlot; ++uSlot)
         {
-            delete (lCell.second);
+            const u8 c_uNewClr = pTile->muColor[uSlot];
+            if (0 != pTile->muValid[uSlot] && 0 != pOwnTile->muValid[uSlot] && pOwnTile->muColor[uSlot] != c_uNewClr && NUM_CELL_COLORS > c_uNewClr)
+            {
+                mCellStore.SetColor((uTile << CELL_TILE_SHIFT) | uSlot, PaletteToColor(c_uNewClr));
+            }
         }
     }
 
-    // Clear the nations out.
-    for (std::vector<CNation*>::iterator iNatIter = mvNations.begin(); iNatIter != mvNations.end(); ++iNatIter)
+    // Hand the cells between the nations a word at a time: each nation drops whatever isn't it's color any more and picks up whatever is.
+    BuildColorCells();
+
+    CCellBitset lLost;
+    for (std::vector<CNation*>::iterator pNatIter = mvNations.begin(); pNatIter != mvNations.end(); ++pNatIter)
     {
-        CNation* pTmpNat = (*iNatIter);
-        if (nullptr != pTmpNat)
-        {
-            delete pTmpNat;
-        }
+        const u8 c_uClr = ColorToPalette((*pNatIter)->GetNationColor());
+        if (PALETTE_NONE == c_uClr) { continue; }
+
+        lLost = (*pNatIter)->GetCells();
+        lLost.AndNot(mvColorCells[c_uClr]);
+        (*pNatIter)->RemoveCells(lLost);
+        (*pNatIter)->AddCells(mvColorCells[c_uClr]);
     }
 
-    // Clear out the combs.
-    for (std::vector<CHoneyComb*>::iterator iCombIter = mpBoardCombs.begin(); iCombIter != mpBoardCombs.end(); ++iCombIter)
+    for (CombIterator pIter = mpBoardCombs.begin(); pIter != mpBoardCombs.end(); ++pIter) { (*pIter)->RecountColors(); }
+
+    BuildFrontiers();
+
+    if (!mbHeadless)
     {
-        CHoneyComb* pTmpComb = (*iCombIter);
-        if (nullptr != pTmpComb)
-        {
-            delete pTmpComb;
-        }
+        mTerritories.Build(&mCellStore);
+        mTerritories.ClearEvents();
     }
+    mDistances.Build(&mCellStore);
 
-    // Clear the cell map.
-    mmCellMap.clear();
-
-    // Clear the nation list.
-    mvNations.clear();
+    return true;
+}
 
-    // Clear the combs.
-    mpBoardCombs.clear();
+/*!
+ * \brief CBoard::PublishSnapshot
+ *
+ * This method publishes the current state of the board's cells to readers (see GetSnapshot). It should be called by the thread making moves once a move is done,
+ * so readers never see a half-made move. Only the tile table is copied, tiles are shared until the board writes to them again. Publishing again without any write in
+ * between keeps the snapshot already out there. The published snapshot is the only one the board holds, so a tile written after publishing gets copied at most
+ * once per publish.
+ */
+void CBoard::PublishSnapshot()
+{
+    std::shared_ptr<const CCellSnapshot> pPublished = std::atomic_load(&mpSnapshot);
+    if (nullptr != pPublished && pPublished->GetVersion() == mCellStore.GetVersion() && pPublished->GetNumTiles() == mCellStore.GetNumTiles()) { return; }
 
-    // Clear the color last map.
-    mColorLastMap.clear();
+    std::atomic_store(&mpSnapshot, mCellStore.Snapshot());
 }
 
 /*!
  * \brief CBoard::Draw
  *
- * This function simply iterates over the comb array and calls "Draw" on the combs.
+ * This function simply iterates over the board's cells and calls "Draw" on them.
  * \param pPainter - Pointer to a device context to paint to.
  */
 void CBoard::Draw(QPainter *pPainter)
 {
     if (nullptr != pPainter)
     {
-        for (CombIterator pIter = mpBoardCombs.begin(); pIter != mpBoardCombs.end(); ++pIter)
+        // Stream straight through the cell store rather than hopping comb to comb.
+        for (u32 uTile = 0; mCellStore.GetNumTiles() > uTile; ++uTile)
         {
-            if (nullptr != (*pIter))
+            const SCellTile* pTile = mCellStore.GetTile(uTile);
+            if (nullptr == pTile) { continue; }
+
+            for (u32 uSlot = 0; CELL_TILE_SZ > uSlot; ++uSlot)
             {
-                (*pIter)->Draw(pPainter);
+                if (0 != pTile->muValid[uSlot])
+                {
+                    mvCellTiles[uTile][uSlot].Draw(pPainter);
+                }
             }
         }
 
@@ -319,90 +619,36 @@ CHoneyComb* CBoard::GetComb(u32 uCombIdx)
  *
  * This function is used so the CGame class can have a reference to the nation vector for manipulation purposes.
  *
- * \return Pointer to the nation vector.
+ * \return Reference to the nation vector (copy it to keep it past the next "Create" or "Destroy").
  */
-std::vector<CNation *> CBoard::GetNationList()
+const std::vector<CNation*>& CBoard::GetNationList()
 {
     return mvNations;
 }
 
-std::map<u64, CCell*> CBoard::GetCellMap()
-{
-    return mmCellMap;
-}
-
+/*!
+ * \brief CBoard::GetCellNeighbors
+ *
+ * This function returns the cells bordering the given cell. The neighbors are read straight out of the neighbor masks built by "Create", so no geometric searching is done here.
+ *
+ * \param uCellID - The ID of the cell to get the neighbors of.
+ * \return Vector of the neighboring cells (at most NUM_HEX_VERTS), empty if the cell doesn't exist.
+ */
 std::vector<CCell*> CBoard::GetCellNeighbors(u64 uCellID)
 {
     std::vector<CCell*> vNeighbors;
 
-    if (nullptr != mpBoardCombs[0])
+    u32 pNeighbors[NUM_HEX_VERTS];
+    const u32 c_uCount = GetNeighborIndices(GetCellIndex(uCellID), pNeighbors);
+    if (0 < c_uCount)
     {
-        // Begin calculating the collision points.
-        // Simple variable to help us track half-height of the polygon.
-        const float c_nCircumRadius = mpBoardCombs[0]->GetCombSize() / 2.0f;
-        const float c_nDegreePerAngle = 180.0f / 3.0f; // Should be 60.0f
-
-        SPoint lPos;
-        lPos.setX((uCellID & 0xffffffff00000000) >> 32);
-        lPos.setY(uCellID & 0x00000000ffffffff);
-
-        QString lMsg("Looking for neigbors of (%1, %2)...");
-        lMsg = lMsg.arg(lPos.mX).arg(lPos.mY);
-        qDebug(lMsg.toStdString().c_str());
-
-        bool bShouldBreak = false;
-        if ((801 <= lPos.mX && 803 >= lPos.mX) && (1025 <= lPos.mY && 1027 >= lPos.mY) && g_cfgVars.mbIsDebug)
-        {
-            bShouldBreak = true;
-        }
-
-        float nX = lPos.mX - c_nCircumRadius;
-        float nY = lPos.mY;
-        float nTheta = static_cast<float>(MAX_DEGREE - c_nDegreePerAngle); // We start with a negative degree.
-
-        // Begin calculating the points (counter-clockwise, starting at top).
-        //!\NOTE: Our hexagons have the long-leg vertical, meaning they're pointed at the top. (height > width)
-        std::map<u64, CCell*>::iterator iCellIter;
-        for (size_t iIdx = 0; NUM_HEX_VERTS > iIdx; ++iIdx)
+        vNeighbors.reserve(c_uCount);
+        for (u32 uIdx = 0; c_uCount > uIdx; ++uIdx)
         {
-            if (g_cfgVars.mbIsDebug) { l_CollisionPoints[iIdx] = QPointF(nX, nY); }
-
-            for (iCellIter = mmCellMap.begin(); iCellIter != mmCellMap.end(); ++iCellIter)
-            {
-                std::pair<u64, CCell*> lCell = (*iCellIter);
-                SPoint lPt(nX, nY);
-
-                if (g_cfgVars.mbIsDebug && nullptr != lCell.second && lCell.second->GetColor() == Cell_White && bShouldBreak)
-                {
-                    std::raise(SIGINT); // BREAK!
-                }
-
-                if (nullptr != lCell.second && lCell.second->PointInHex(lPt))
-                {
-                    QString lMsg("Found neigbor @ (%1, %2) [Real: %3, %4]");
-                    lMsg = lMsg.arg(lPt.mX).arg(lPt.mY);
-                    lMsg = lMsg.arg(lCell.second->GetPosition().mX).arg(lCell.second->GetPosition().mY);
-                    qDebug(lMsg.toStdString().c_str());
-
-                    vNeighbors.push_back(lCell.second);
-                    break;
-                }
-            }
+            CCell* pCell = GetCell(pNeighbors[uIdx]);
+            vNeighbors.push_back(pCell);
 
-            // Calculate the next position.
-            float nThetaRad = static_cast<float>(nTheta * (M_PI / 180.0f));
-            float nXDelta = c_nCircumRadius * cos(nThetaRad);
-            float nYDelta = c_nCircumRadius * sin(nThetaRad);
-
-            // Subtract both.
-            nX += nXDelta;
-            nY += nYDelta;
-
-            nTheta += c_nDegreePerAngle;
-            if (nTheta >= MAX_DEGREE)
-            {
-                nTheta -= MAX_DEGREE;
-            }
+            if (g_cfgVars.mbIsDebug) { l_CollisionPoints[uIdx] = QPointF(pCell->GetPosition().mX, pCell->GetPosition().mY); }
         }
     }
 
@@ -417,12 +663,7 @@ std::vector<CCell*> CBoard::GetCellNeighbors(CHoneyComb* pComb, u32 uCellIdx)
         CCell* pOriginCell = pComb->GetCellAt(uCellIdx);
         if (nullptr != pOriginCell)
         {
-            SPoint sPos = pOriginCell->GetPosition();
-            u64 uCellID = static_cast<u32>(sPos.mX);
-            uCellID = uCellID << (WORD_SZ / 2);
-            uCellID += static_cast<u32>(sPos.mY);
-
-            lRtn = GetCellNeighbors(uCellID);
+            lRtn = GetCellNeighbors(pOriginCell->GetCoord().ToID());
         }
     }
 
@@ -434,152 +675,779 @@ std::vector<CCell*> CBoard::GetCellNeighbors(u32 uCombIdx, u32 uCellIdx)
     return GetCellNeighbors(GetComb(uCombIdx), uCellIdx);
 }
 
-CNation* CBoard::ColorToNation(ECellColors eColor)
+/*!
+ * \brief CBoard::GetCellCount
+ *
+ * This function returns the number of cell indices on the board (one past the largest valid cell index). Indices cover the lattice bounding box of the board, so
+ * some of them are holes that "GetCell" returns nullptr for.
+ *
+ * \return Number of cell indices on the board.
+ */
+u32 CBoard::GetCellCount()
 {
-    CNation* pNat = nullptr;
-    for (std::vector<CNation*>::iterator iNatIter = mvNations.begin(); iNatIter != mvNations.end(); ++iNatIter)
-    {
-        CNation* pNation = (*iNatIter);
-        if (nullptr != pNation && pNation->GetNationColor() == eColor)
-        {
-            pNat = pNation;
-            break;
-        }
-    }
-
-    return pNat;
+    return mCellStore.GetCount();
 }
 
 /*!
- * \brief CBoard::SetBoardSize
+ * \brief CBoard::GetNumValidCells
  *
- * This method is used to set the number of tessellation layers the board should use. These layers are the number of "cirlces" that go around the center honeycomb.
- * Default is 2 for a "medium" board. A large board would be "4" and a small board would be "1".
+ * This function returns the number of actual cells on the board (unlike "GetCellCount", holes in the index space aren't counted).
  *
- * \param[in] uSz - Number of layers.
+ * \return Number of cells on the board.
  */
-void CBoard::SetBoardSize(u32 uSz)
+u32 CBoard::GetNumValidCells()
 {
-    miSize = uSz;
+    return muNumValidCells;
 }
 
 /*!
- * \brief CBoard::CalcTessPos
+ * \brief CBoard::GetColorCount
  *
- * This method is used to calculate all the positions of the honeycombs being tessellated for a given layer. These are calculated using a basic hexagon multiplied by the layer index.
- * Algorithm is as follows:
+ * This function returns how many cells currently have a given color. The counts are kept up to date as cells change color, so this doesn't look at the board.
  *
- *  new SPoint[6 * (iLayerIdx+1)]
- *  for point in array:
- *      if point is hexagon vertex:
- *          calculate next vertex.
- *      calculate X shift amount divided by (layer + 1)
- *      calculate Y shift amount divided by (layer + 1)
- *      shift X by x-shift
- *      shift Y by y-shift
- *      Set point position to (x,y)
- *  done
- *
- * \param aStart - The start position (should be top-most comb).
- * \param iLayerIdx - The layer index we're at.
- * \return Pointer which references a heap-allocated array of SPoint references or nullptr upon error.
+ * \param eClr - Color to count.
+ * \return Number of cells with the color.
  */
-std::vector<SPoint> CBoard::CalcTessPos(SPoint& aStart, u32 iLayerIdx, u32 uCellSz, u32 uTessLegLen)
+u32 CBoard::GetColorCount(ECellColors eClr)
 {
-    const u32 c_uCellRadius = uCellSz / 2;
-    mnCombSz = static_cast<float>(c_uCellRadius * CELL_COMB_RATIO);
-    const float c_nCombCircumRadius = (mnCombSz * TESS_COMBSZ_TO_TESSSZ);
-    const float c_nDegreePerAngle = 180.0f / 3.0f; // Should be 60.0f
-    const u32 c_iNumPoints = NUM_HEX_VERTS * (iLayerIdx + 1);
-
-    float nX = aStart.x();
-    float nY = aStart.y();
-    float nTheta = static_cast<float>(MAX_DEGREE - c_nDegreePerAngle); // We start with a negative degree.
-
-    // Create the array.
-    std::vector<SPoint> mpPointArr;
-    mpPointArr.push_back(SPoint(nX, nY));
-
-    // Calculate the next position.
-    float nThetaRad = static_cast<float>((nTheta - TESS_ROTATION) * (M_PI / 180.0f));
-    float nNxtVertX = uTessLegLen * sin(nThetaRad);
-    float nNxtVertY = uTessLegLen * cos(nThetaRad);
+    const u8 c_uIdx = ColorToPalette(eClr);
+    return (mvColorCounts.size() > c_uIdx) ? mvColorCounts[c_uIdx] : 0;
+}
 
-    // Calculate the "current" position.
-    float nXDelta = c_nCombCircumRadius * sin(nThetaRad);
-    float nYDelta = c_nCombCircumRadius * cos(nThetaRad);
+/*!
+ * \brief CBoard::ColorDominates
+ *
+ * This function checks if a color holds at least a given share of the board's cells.
+ *
+ * \param eClr - Color to check.
+ * \param nShare - Share of the cells needed, from 0 to 1.
+ * \return True if the color holds at least that share of the board.
+ */
+bool CBoard::ColorDominates(ECellColors eClr, float nShare)
+{
+    return (0 < muNumValidCells) && (static_cast<double>(GetColorCount(eClr)) >= static_cast<double>(nShare) * muNumValidCells);
+}
 
-    const u32 uVarience = static_cast<u32>(uCellSz * 0.05f);
+/*!
+ * \brief CBoard::GetCellIndex
+ *
+ * This function converts a cell ID into it's dense cell index.
+ *
+ * \param uCellID - The ID of the cell.
+ * \return The cell index, or INVALID_CELL_IDX if the cell doesn't exist.
+ */
+u32 CBoard::GetCellIndex(u64 uCellID)
+{
+    return CoordToIndex(SHexCoord::FromID(uCellID));
+}
 
-    // Begin calculating the points (counter-clockwise, starting at top).
-    //!\NOTE: Our hexagons have the long-leg vertical, meaning they're pointed at the top. (height > width)
-    for (size_t iIdx = 1; c_iNumPoints > iIdx; ++iIdx)
-    {
-        // Set the comb position.
-        mpPointArr.push_back(SPoint(nX + nXDelta, nY + nYDelta));
+/*!
+ * \brief CBoard::GetNeighborCells
+ *
+ * This method finds every cell bordering a set of cells (the set itself is only included where it borders itself). It's six masked, shifted ORs over the whole
+ * board, 64 cells per word.
+ *
+ * \param[in] aCells - Cells to find the neighbors of.
+ * \param[out] aNeighbors - Cells with at least one neighbor in aCells.
+ */
+void CBoard::GetNeighborCells(const CCellBitset& aCells, CCellBitset& aNeighbors)
+{
+    aNeighbors.Resize(mCellStore.GetCount());
+    for (u32 uDir = 0; mvDirMasks.size() > uDir; ++uDir)
+    {
+        aNeighbors.OrShifted(aCells, mvDirMasks[uDir], mvDirShifts[uDir]);
+    }
+}
 
-        if (floor(nXDelta) <= floor(nNxtVertX) + uVarience &&
-            floor(nXDelta) >= floor(nNxtVertX) - uVarience &&
-            floor(nYDelta) <= floor(nNxtVertY) + uVarience &&
-            floor(nYDelta) >= floor(nNxtVertY) - uVarience)
-        {
-            // Add both.
-            nX += nXDelta;
-            nY += nYDelta;
+/*!
+ * \brief CBoard::NationsBorder
+ *
+ * This function checks if two colors currently touch anywhere on the board. It's answered from the maintained frontiers so it costs the same on any board size.
+ *
+ * \param eAggressor - Color doing the attacking.
+ * \param eVictim - Color being attacked.
+ * \return True if at least one eVictim cell neighbors an eAggressor cell, false otherwise.
+ */
+bool CBoard::NationsBorder(ECellColors eAggressor, ECellColors eVictim)
+{
+    const u32 c_uSlot = FrontierSlot(eAggressor, eVictim);
+    return (mvFrontierSizes.size() > c_uSlot) && (0 < mvFrontierSizes[c_uSlot]);
+}
 
-            // Update theta.
-            nTheta += c_nDegreePerAngle;
-            if (nTheta >= MAX_DEGREE)
+/*!
+ * \brief CBoard::GetFrontier
+ *
+ * This function gets the contested cells between two colors, i.e. the eVictim cells with at least one eAggressor neighbor. The set is kept up to date by
+ * "SetCellColor", so attacks can expand straight from it.
+ *
+ * \param eAggressor - Color doing the attacking.
+ * \param eVictim - Color being attacked.
+ * \return The contested cells (an empty set if the colors have never touched).
+ */
+const CCellBitset& CBoard::GetFrontier(ECellColors eAggressor, ECellColors eVictim)
+{
+    const u32 c_uSlot = FrontierSlot(eAggressor, eVictim);
+    return (mvFrontiers.size() > c_uSlot) ? mvFrontiers[c_uSlot] : mEmptyFrontier;
+}
+
+/*!
+ * \brief CBoard::FloodFill
+ *
+ * This function recolors up to "uMaxCells" victim cells to the aggressor, nearest to the aggressor first. It's a breadth-first search over the victim's cells
+ * seeded from the contested cells: each cell taken queues it's victim neighbors that haven't been queued yet. The visited set is only ever touched at queued cells
+ * (and cleared the same way), so a fill costs in proportion to the cells it takes and their neighbors, not to the size of either color.
+ *
+ * \note Nation ownership is left to the caller, "pTaken" says which cells changed hands.
+ *
+ * \param eAggressor - Color doing the attacking.
+ * \param eVictim - Color being attacked.
+ * \param uMaxCells - Most cells to take.
+ * \param pTaken - If given, the taken cells are appended to it (in the order they were taken).
+ * \return Number of cells taken.
+ */
+u32 CBoard::FloodFill(ECellColors eAggressor, ECellColors eVictim, u32 uMaxCells, std::vector<u32>* pTaken)
+{
+    if (!NationsBorder(eAggressor, eVictim)) { return 0; }
+
+    if (mFillVisited.GetSize() != mCellStore.GetCount()) { mFillVisited.Resize(mCellStore.GetCount()); }
+
+    // Seed the queue with the contested cells (copied out, the set changes as cells are taken).
+    mvFillQueue.clear();
+    for (u32 uCellIdx : GetFrontier(eAggressor, eVictim))
+    {
+        mFillVisited.Set(uCellIdx);
+        mvFillQueue.push_back(uCellIdx);
+    }
+
+    u32 uCellsTaken = 0;
+    u32 pNeighbors[NUM_HEX_VERTS];
+    for (size_t uHead = 0; mvFillQueue.size() > uHead && uCellsTaken < uMaxCells; ++uHead)
+    {
+        const u32 c_uCellIdx = mvFillQueue[uHead];
+        SetCellColor(c_uCellIdx, eAggressor);
+        ++uCellsTaken;
+
+        const u32 c_uNumNeighbors = GetNeighborIndices(c_uCellIdx, pNeighbors);
+        for (u32 uNeigh = 0; c_uNumNeighbors > uNeigh; ++uNeigh)
+        {
+            if (!mFillVisited.Test(pNeighbors[uNeigh]) && eVictim == mCellStore.GetColor(pNeighbors[uNeigh]))
             {
-                nTheta -= MAX_DEGREE;
+                mFillVisited.Set(pNeighbors[uNeigh]);
+                mvFillQueue.push_back(pNeighbors[uNeigh]);
             }
+        }
+    }
 
-            // Recalculate the next vertex.
-            nThetaRad = static_cast<float>((nTheta - TESS_ROTATION) * (M_PI / 180.0f));
-            nNxtVertX = uTessLegLen * sin(nThetaRad);
-            nNxtVertY = uTessLegLen * cos(nThetaRad);
+    if (nullptr != pTaken) { pTaken->insert(pTaken->end(), mvFillQueue.begin(), mvFillQueue.begin() + uCellsTaken); }
+    for (std::vector<u32>::iterator pCellIter = mvFillQueue.begin(); pCellIter != mvFillQueue.end(); ++pCellIter) { mFillVisited.Reset(*pCellIter); }
 
-            // Re-Calculate the next position.
-            nXDelta = c_nCombCircumRadius * sin(nThetaRad);
-            nYDelta = c_nCombCircumRadius * cos(nThetaRad);
-        }
-        else
+    return uCellsTaken;
+}
+
+/*!
+ * \brief CBoard::InfectionStep
+ *
+ * This function runs one synchronous infection round: every victim cell touching the aggressor is picked with the given chance, all against the board as it
+ * stands (nothing is recolored here, the caller applies the result). The contested set is exactly the cells that can be infected, so a round is a single
+ * CCellBitset::Sample pass over it. Large boards split that pass over several threads (up to the limit set with SetMaxThreads), each sampling it's own range of
+ * words. The threads are a pool kept with the board, so rounds don't start threads of their own.
+ *
+ * \param eAggressor - Color doing the infecting.
+ * \param eVictim - Color being infected.
+ * \param nChance - Chance [0 - 1] of each contested cell being infected.
+ * \param uSeed - Seed for the round, the same seed on the same board infects the same cells.
+ * \param aInfected - Receives the infected cells.
+ * \return Number of infected cells.
+ */
+u32 CBoard::InfectionStep(ECellColors eAggressor, ECellColors eVictim, float nChance, u64 uSeed, CCellBitset& aInfected)
+{
+    if (aInfected.GetSize() != mCellStore.GetCount()) { aInfected.Resize(mCellStore.GetCount()); }
+
+    const CCellBitset& lFrontier = GetFrontier(eAggressor, eVictim);
+    if (lFrontier.GetSize() != aInfected.GetSize())
+    {
+        aInfected.Clear();
+        return 0;
+    }
+
+    const u64 c_uThreshold = (1.0f <= nChance) ? (1ULL << 32) : (0.0f < nChance) ? static_cast<u64>(static_cast<double>(nChance) * 4294967296.0) : 0;
+    const u32 c_uNumWords = lFrontier.GetNumWords();
+    const u32 c_uMaxThreads = (0 < muMaxThreads) ? muMaxThreads : std::thread::hardware_concurrency();
+    const u32 c_uNumThreads = std::max(1u, std::min(c_uMaxThreads, c_uNumWords / INFECTION_WORDS_PER_THREAD));
+    if (1 == c_uNumThreads)
+    {
+        aInfected.Sample(lFrontier, c_uThreshold, uSeed, 0, c_uNumWords);
+    }
+    else
+    {
+        if (nullptr == mpInfectPool) { mpInfectPool = new CWorkerPool(c_uMaxThreads - 1); }
+
+        const u32 c_uWordsPerThread = (c_uNumWords + c_uNumThreads - 1) / c_uNumThreads;
+        mpInfectPool->Run(c_uNumThreads, [&aInfected, &lFrontier, c_uThreshold, uSeed, c_uWordsPerThread](u32 uJob) {
+            aInfected.Sample(lFrontier, c_uThreshold, uSeed, uJob * c_uWordsPerThread, (uJob + 1) * c_uWordsPerThread);
+        });
+    }
+
+    return aInfected.Count();
+}
+
+/*!
+ * \brief CBoard::Infect
+ *
+ * This function runs an infection round (see InfectionStep) and recolors up to "uMaxCells" of the infected cells to the aggressor. When more cells are infected
+ * than can be taken, which ones are taken is drawn uniformly at random from the round's seed, so the cap doesn't favor any part of the board.
+ *
+ * \note Nation ownership is left to the caller, "pTaken" says which cells changed hands.
+ *
+ * \param eAggressor - Color doing the infecting.
+ * \param eVictim - Color being infected.
+ * \param nChance - Chance [0 - 1] of each contested cell being infected.
+ * \param uSeed - Seed for the round.
+ * \param uMaxCells - Most cells to take.
+ * \param pTaken - If given, the taken cells are appended to it.
+ * \return Number of cells taken.
+ */
+u32 CBoard::Infect(ECellColors eAggressor, ECellColors eVictim, float nChance, u64 uSeed, u32 uMaxCells, std::vector<u32>* pTaken)
+{
+    const u32 c_uNumInfected = InfectionStep(eAggressor, eVictim, nChance, uSeed, mInfected);
+    if (c_uNumInfected <= uMaxCells)
+    {
+        for (CCellBitset::CIterator pCellIter = mInfected.begin(); pCellIter != mInfected.end(); ++pCellIter)
         {
-            // Calculate the next position.
-            nXDelta += c_nCombCircumRadius * sin(nThetaRad);
-            nYDelta += c_nCombCircumRadius * cos(nThetaRad);
+            SetCellColor(*pCellIter, eAggressor);
+            if (nullptr != pTaken) { pTaken->push_back(*pCellIter); }
         }
+
+        return c_uNumInfected;
+    }
+
+    // Too many to take them all, shuffle just enough of them to the front to pick "uMaxCells" (a partial Fisher-Yates shuffle).
+    mvFillQueue.clear();
+    for (CCellBitset::CIterator pCellIter = mInfected.begin(); pCellIter != mInfected.end(); ++pCellIter) { mvFillQueue.push_back(*pCellIter); }
+
+    std::mt19937_64 lEngine(uSeed ^ 0x9e3779b97f4a7c15ULL); // Not the raw seed, Sample already hashed it to pick the cells.
+    for (u32 uPick = 0; uMaxCells > uPick; ++uPick)
+    {
+        std::uniform_int_distribution<u32> lDist(uPick, c_uNumInfected - 1);
+        std::swap(mvFillQueue[uPick], mvFillQueue[lDist(lEngine)]);
     }
 
-    return mpPointArr;
+    std::sort(mvFillQueue.begin(), mvFillQueue.begin() + uMaxCells);
+    for (u32 uPick = 0; uMaxCells > uPick; ++uPick) { SetCellColor(mvFillQueue[uPick], eAggressor); }
+    if (nullptr != pTaken) { pTaken->insert(pTaken->end(), mvFillQueue.begin(), mvFillQueue.begin() + uMaxCells); }
+
+    return uMaxCells;
+}
+
+/*!
+ * \brief CBoard::CoordToIndex
+ *
+ * This function converts a lattice coordinate into it's cell index. Cell indices are laid out row by row over the board's bounding box, so this is plain arithmetic.
+ *
+ * \param aCoord - Axial coordinate of the cell.
+ * \return The cell index, or INVALID_CELL_IDX if there's no cell at that coordinate.
+ */
+u32 CBoard::CoordToIndex(const SHexCoord& aCoord)
+{
+    const u32 uCellIdx = mCellStore.CoordToIndex(aCoord);
+    return mCellStore.IsValid(uCellIdx) ? uCellIdx : INVALID_CELL_IDX;
+}
+
+/*!
+ * \brief CBoard::IndexToCoord
+ *
+ * This function converts a cell index back into it's lattice coordinate.
+ *
+ * \param uCellIdx - Index of the cell.
+ * \return Axial coordinate of the cell.
+ */
+SHexCoord CBoard::IndexToCoord(u32 uCellIdx)
+{
+    return mCellStore.IndexToCoord(uCellIdx);
+}
+
+/*!
+ * \brief CBoard::CoordToPixel
+ *
+ * This function returns the pixel center of the cell at the given lattice coordinate.
+ *
+ * \param aCoord - Axial coordinate of the cell.
+ * \return Center of the cell in pixels.
+ */
+SPoint CBoard::CoordToPixel(const SHexCoord& aCoord)
+{
+    return SPoint(mCenter.mX + mnCellRadius * c_nHexSqrt3 * (static_cast<float>(aCoord.mQ) + static_cast<float>(aCoord.mR) / 2.0f),
+                  mCenter.mY + mnCellRadius * 1.5f * static_cast<float>(aCoord.mR));
+}
+
+/*!
+ * \brief CBoard::PixelToCoord
+ *
+ * This function returns the lattice coordinate of the cell whose hexagon contains the given pixel (see SHexCoord::FromPixel).
+ *
+ * \param aPt - Position in pixels.
+ * \return Axial coordinate of the cell under the point.
+ */
+SHexCoord CBoard::PixelToCoord(const SPoint& aPt)
+{
+    if (0.0f >= mnCellRadius) { return SHexCoord(); }
+
+    return SHexCoord::FromPixel((aPt.mX - mCenter.mX) / mnCellRadius, (aPt.mY - mCenter.mY) / mnCellRadius);
+}
+
+/*!
+ * \brief CBoard::GetCellIdxAtPoint
+ *
+ * This function finds the cell under a canvas point. The cells sit on a regular lattice, so the point is rounded straight to it's lattice coordinate; no cells or
+ * combs are searched and the cost is the same on any board size.
+ *
+ * \param aPt - Position in pixels.
+ * \return Index of the cell under the point, or INVALID_CELL_IDX if the point is off the board.
+ */
+u32 CBoard::GetCellIdxAtPoint(const SPoint& aPt)
+{
+    if (0.0f >= mnCellRadius) { return INVALID_CELL_IDX; }
+
+    return CoordToIndex(PixelToCoord(aPt));
+}
+
+/*!
+ * \brief CBoard::GetCellAtPoint
+ *
+ * This function finds the cell under a canvas point (see "GetCellIdxAtPoint").
+ *
+ * \param aPt - Position in pixels.
+ * \return The cell under the point, or nullptr if the point is off the board.
+ */
+CCell* CBoard::GetCellAtPoint(const SPoint& aPt)
+{
+    return GetCell(GetCellIdxAtPoint(aPt));
+}
+
+/*!
+ * \brief CBoard::GetCell
+ *
+ * This function returns the cell at the given cell index.
+ *
+ * \param uCellIdx - Index of the cell.
+ * \return The cell, or nullptr if the index is out of range.
+ */
+CCell* CBoard::GetCell(u32 uCellIdx)
+{
+    return mCellStore.IsValid(uCellIdx) ? &mvCellTiles[uCellIdx >> CELL_TILE_SHIFT][uCellIdx & CELL_TILE_MASK] : nullptr;
 }
 
-void CBoard::AddCellToNation(ECellColors eClr, u64 uCellID)
+/*!
+ * \brief CBoard::GetCellStore
+ *
+ * This function returns the store holding the state of every cell on the board. It's meant for code that wants to stream over the whole board at once.
+ *
+ * \return Pointer to the board's cell store.
+ */
+CCellStore* CBoard::GetCellStore()
 {
-    // Check to see if we have that nation.
-    bool bFoundNation = false;
-    CNation* pNation = nullptr;
+    return &mCellStore;
+}
+
+/*!
+ * \brief CBoard::GetTerritories
+ *
+ * This function returns the board's territory tracker (the connected regions of each color), which "SetCellColor" keeps up to date. Headless boards don't track
+ * territories, theirs is always empty.
+ *
+ * \return Pointer to the board's territories.
+ */
+CTerritories* CBoard::GetTerritories()
+{
+    return &mTerritories;
+}
+
+/*!
+ * \brief CBoard::GetDistanceFields
+ *
+ * This function returns the board's per-color distance fields (how far every cell is from each color), which "SetCellColor" keeps up to date.
+ *
+ * \return Pointer to the board's distance fields.
+ */
+CDistanceFields* CBoard::GetDistanceFields()
+{
+    return &mDistances;
+}
+
+/*!
+ * \brief CBoard::GetSnapshot
+ *
+ * This function returns the last published snapshot of the board's cells (see PublishSnapshot). It's safe to call from any thread, and the snapshot stays
+ * consistent for as long as the caller holds on to it no matter what the board does in the mean time.
+ *
+ * \return The snapshot, or nullptr if the board hasn't been created.
+ */
+std::shared_ptr<const CCellSnapshot> CBoard::GetSnapshot()
+{
+    return std::atomic_load(&mpSnapshot);
+}
+
+/*!
+ * \brief CBoard::GetNeighborIndices
+ *
+ * This function gets the indices of the cells bordering a cell, in direction order (see CCellStore::GetNeighborIndices).
+ *
+ * \param[in] uCellIdx - Index of the cell.
+ * \param[out] pNeighbors - Receives the neighbor indices, must have room for NUM_HEX_VERTS entries.
+ * \return Number of neighbors written (0 if the cell doesn't exist).
+ */
+u32 CBoard::GetNeighborIndices(u32 uCellIdx, u32* pNeighbors)
+{
+    return mCellStore.GetNeighborIndices(uCellIdx, pNeighbors);
+}
+
+CNation* CBoard::ColorToNation(ECellColors eColor)
+{
+    CNation* pNat = nullptr;
     for (std::vector<CNation*>::iterator iNatIter = mvNations.begin(); iNatIter != mvNations.end(); ++iNatIter)
     {
-        pNation = (*iNatIter);
-        if (nullptr != pNation && pNation->GetNationColor() == eClr)
+        CNation* pNation = (*iNatIter);
+        if (nullptr != pNation && pNation->GetNationColor() == eColor)
         {
-            bFoundNation = true;
+            pNat = pNation;
             break;
         }
     }
 
-    if (nullptr != pNation && bFoundNation)
+    return pNat;
+}
+
+/*!
+ * \brief CBoard::SetCellColor
+ *
+ * This method recolors a single cell, updates the board's and it's honeycomb's color counts, the territories, the distance fields and patches the contested sets around it. Only the cell and it's (at most six) neighbors can change contested state, so a
+ * recolor costs the same no matter how large the board or the nations are.
+ *
+ * \note Nation ownership is left to the caller, this only deals with cell state.
+ *
+ * \param uCellIdx - Index of the cell to recolor.
+ * \param eClr - New color of the cell.
+ */
+void CBoard::SetCellColor(u32 uCellIdx, ECellColors eClr)
+{
+    if (!mCellStore.IsValid(uCellIdx)) { return; }
+
+    const ECellColors eOldClr = mCellStore.GetColor(uCellIdx);
+    if (eOldClr == eClr || PALETTE_NONE == ColorToPalette(eClr)) { return; }
+
+    mCellStore.SetColor(uCellIdx, eClr);
+    if (!mvColorCounts.empty())
     {
-        pNation->Add(uCellID);
+        --mvColorCounts[ColorToPalette(eOldClr)];
+        ++mvColorCounts[ColorToPalette(eClr)];
     }
-    else
+
+    const u32 c_uCombIdx = mCellStore.GetComb(uCellIdx);
+    if (mpBoardCombs.size() > c_uCombIdx)
+    {
+        mpBoardCombs[c_uCombIdx]->CellColorChanged(eOldClr, eClr);
+    }
+
+    if (!mbHeadless) { mTerritories.CellRecolored(uCellIdx, eOldClr, eClr); }
+    mDistances.CellRecolored(uCellIdx, eOldClr, eClr);
+
+    u32 pNeighbors[NUM_HEX_VERTS];
+    const u32 c_uNumNeighbors = GetNeighborIndices(uCellIdx, pNeighbors);
+    for (u32 uNeigh = 0; c_uNumNeighbors > uNeigh; ++uNeigh)
+    {
+        const u32 c_uNeighIdx = pNeighbors[uNeigh];
+        const ECellColors eNeighClr = mCellStore.GetColor(c_uNeighIdx);
+
+        // The cell itself moves from the old color's sets to the new color's.
+        UpdateFrontier(eNeighClr, eOldClr, uCellIdx, false);
+        UpdateFrontier(eNeighClr, eClr, uCellIdx, true);
+
+        // The neighbor now touches the new color, and may have lost it's last cell of the old color.
+        UpdateFrontier(eClr, eNeighClr, c_uNeighIdx, true);
+
+        u32 pNeighNeighbors[NUM_HEX_VERTS];
+        const u32 c_uNumNeighNeighbors = GetNeighborIndices(c_uNeighIdx, pNeighNeighbors);
+
+        bool bStillTouches = false;
+        for (u32 uNeighNeigh = 0; c_uNumNeighNeighbors > uNeighNeigh && !bStillTouches; ++uNeighNeigh)
+        {
+            bStillTouches = (mCellStore.GetColor(pNeighNeighbors[uNeighNeigh]) == eOldClr);
+        }
+
+        if (!bStillTouches) { UpdateFrontier(eOldClr, eNeighClr, c_uNeighIdx, false); }
+    }
+}
+
+/*!
+ * \brief CBoard::SetBoardSize
+ *
+ * This method is used to set the number of tessellation layers the board should use. These layers are the number of "cirlces" that go around the center honeycomb.
+ * Default is 2 for a "medium" board. A large board would be "4" and a small board would be "1".
+ *
+ * \param[in] uSz - Number of layers.
+ */
+void CBoard::SetBoardSize(u32 uSz)
+{
+    miSize = uSz;
+}
+
+/*!
+ * \brief CBoard::SetTemplateDir
+ *
+ * This method sets the directory board templates are cached in. Boards with the same size, cell size and center are then only generated once.
+ *
+ * \param[in] sDir - Template directory, empty to always generate the board.
+ */
+void CBoard::SetTemplateDir(const QString& sDir)
+{
+    msTemplateDir = sDir;
+}
+
+/*!
+ * \brief CBoard::SetMaxThreads
+ *
+ * This method limits how many threads InfectionStep may split a round over. Boards that are already worked on from a worker thread (see CSimulator) should be
+ * kept to 1, so they don't start threads of their own on top of the workers.
+ *
+ * \param[in] uMaxThreads - Most threads, 0 for one per core.
+ */
+void CBoard::SetMaxThreads(u32 uMaxThreads)
+{
+    muMaxThreads = uMaxThreads;
+
+    // The pool is sized for the old limit, the next big round starts a new one.
+    if (nullptr != mpInfectPool)
+    {
+        delete mpInfectPool;
+        mpInfectPool = nullptr;
+    }
+}
+
+/*!
+ * \brief CBoard::SetHeadless
+ *
+ * This method marks a board as headless: one that's only played on and never shown (see CSimulator). Headless boards don't log, so they can be made and played on
+ * any thread, and don't track territories, which only CGame reads. Set this before "Create".
+ *
+ * \param[in] bHeadless - True for a headless board.
+ */
+void CBoard::SetHeadless(bool bHeadless)
+{
+    mbHeadless = bHeadless;
+}
+
+/*!
+ * \brief CBoard::GetTemplatePath
+ *
+ * This function returns the path of the board template for the current board size, the given cell size and the board center. The template directory is created
+ * if it doesn't exist yet.
+ *
+ * \param uCellSz - This is the size of the cells for the combs.
+ * \return Path of the template file, empty if templates are disabled.
+ */
+QString CBoard::GetTemplatePath(u32 uCellSz)
+{
+    if (msTemplateDir.isEmpty())
+    {
+        return QString();
+    }
+
+    QDir lDir(msTemplateDir);
+    if (!lDir.exists())
+    {
+        lDir.mkpath(msTemplateDir);
+    }
+
+    return QString("%1/board_L%2_C%3_%4x%5.cwb").arg(msTemplateDir).arg(miSize).arg(uCellSz).arg(static_cast<s32>(mCenter.mX)).arg(static_cast<s32>(mCenter.mY));
+}
+
+/*!
+ * \brief CBoard::AddCellsToNation
+ *
+ * This method hands a set of cells to the nation of the given color, creating the nation if it doesn't exist yet.
+ *
+ * \param eClr - Color of the nation.
+ * \param aCells - Cells to add.
+ */
+void CBoard::AddCellsToNation(ECellColors eClr, const CCellBitset& aCells)
+{
+    CNation* pNation = ColorToNation(eClr);
+    if (nullptr == pNation)
     {
-        pNation = new CNation();
-        pNation->Create(eClr, g_ColorNameMap[eClr]);
-        pNation->Add(uCellID);
+        pNation = mNationArena.Alloc();
+        pNation->Create(eClr, ColorName(eClr), &mCellStore);
         mvNations.push_back(pNation);
 
-        qInfo(QString("Added %1 nation to board!").arg(g_ColorNameMap[eClr]).toStdString().c_str());
+        if (!mbHeadless) { qInfo(QString("Added %1 nation to board!").arg(ColorName(eClr)).toStdString().c_str()); }
+    }
+
+    pNation->AddCells(aCells);
+}
+
+/*!
+ * \brief CBoard::AddCell
+ *
+ * This method registers a cell with the board by giving it it's starting color, the caller hands it to a nation.
+ *
+ * \param pCell - The cell to add.
+ * \param eClr - The starting color of the cell.
+ */
+void CBoard::AddCell(CCell* pCell, ECellColors eClr)
+{
+    if (nullptr != pCell)
+    {
+        // Set the cell's color.
+        pCell->SetColor(eClr);
+    }
+}
+
+/*!
+ * \brief CBoard::BuildAdjacency
+ *
+ * This method builds the neighbor graph of the board. Each cell only stores which of it's six neighbors exist (see CCellStore::BuildNeighbors), the neighbor
+ * itself is always a fixed index offset away. It runs once per board, after which neighbor lookups are a mask test and an add.
+ */
+void CBoard::BuildAdjacency()
+{
+    mCellStore.BuildNeighbors();
+    BuildDirMasks();
+
+    u32 uNumCells = 0;
+    u64 uNumLinks = 0;
+    for (u32 uTile = 0; mCellStore.GetNumTiles() > uTile; ++uTile)
+    {
+        const SCellTile* pTile = mCellStore.GetTile(uTile);
+        if (nullptr == pTile) { continue; }
+
+        uNumCells += pTile->muNumValid;
+        for (u32 uSlot = 0; CELL_TILE_SZ > uSlot; ++uSlot) { uNumLinks += qPopulationCount(pTile->muNeighbors[uSlot]); }
+    }
+
+    if (!mbHeadless) { qInfo("Built adjacency for %u cells (%llu links).", uNumCells, uNumLinks); }
+}
+
+/*!
+ * \brief CBoard::BuildDirMasks
+ *
+ * This method builds the word-parallel form of the neighbor graph: per direction, the index offset to the neighbor and a mask of the cells that actually have a
+ * neighbor that way. The mask keeps row ends from wrapping and keeps the board edges from leaking into the holes of the bounding box.
+ */
+void CBoard::BuildDirMasks()
+{
+    mvDirShifts.assign(NUM_HEX_VERTS, 0);
+    mvDirMasks.assign(NUM_HEX_VERTS, CCellBitset());
+
+    for (u32 uDir = 0; NUM_HEX_VERTS > uDir; ++uDir)
+    {
+        mvDirShifts[uDir] = mCellStore.GetDirShift(uDir);
+        mvDirMasks[uDir].Resize(mCellStore.GetCount());
+    }
+
+    for (u32 uTile = 0; mCellStore.GetNumTiles() > uTile; ++uTile)
+    {
+        const SCellTile* pTile = mCellStore.GetTile(uTile);
+        if (nullptr == pTile) { continue; }
+
+        for (u32 uSlot = 0; CELL_TILE_SZ > uSlot; ++uSlot)
+        {
+            for (u32 uDir = 0; NUM_HEX_VERTS > uDir; ++uDir)
+            {
+                if (0 != (pTile->muNeighbors[uSlot] & (1 << uDir))) { mvDirMasks[uDir].Set((uTile << CELL_TILE_SHIFT) | uSlot); }
+            }
+        }
+    }
+}
+
+/*!
+ * \brief CBoard::BuildColorCells
+ *
+ * This method splits the cells up by color in one pass over the cell store, filling the per-color cell sets and the per-color counts.
+ */
+void CBoard::BuildColorCells()
+{
+    mvColorCounts.assign(NUM_CELL_COLORS, 0);
+    mvColorCells.resize(NUM_CELL_COLORS);
+    for (std::vector<CCellBitset>::iterator pSetIter = mvColorCells.begin(); pSetIter != mvColorCells.end(); ++pSetIter) { pSetIter->Resize(mCellStore.GetCount()); }
+
+    for (u32 uTile = 0; mCellStore.GetNumTiles() > uTile; ++uTile)
+    {
+        const SCellTile* pTile = mCellStore.GetTile(uTile);
+        if (nullptr == pTile) { continue; }
+
+        for (u32 uSlot = 0; CELL_TILE_SZ > uSlot; ++uSlot)
+        {
+            if (0 != pTile->muValid[uSlot] && NUM_CELL_COLORS > pTile->muColor[uSlot])
+            {
+                mvColorCells[pTile->muColor[uSlot]].Set((uTile << CELL_TILE_SHIFT) | uSlot);
+                ++mvColorCounts[pTile->muColor[uSlot]];
+            }
+        }
+    }
+}
+
+/*!
+ * \brief CBoard::BuildFrontiers
+ *
+ * This method builds the contested cell sets for every pair of colors from scratch, out of the per-color cell sets (see "BuildColorCells"). Each aggressor's
+ * neighbors are found with one word-parallel pass (see "GetNeighborCells"), and each victim's contested set is then just those neighbors AND the victim's cells.
+ * After this they're only ever touched at recolored cells (see "SetCellColor").
+ */
+void CBoard::BuildFrontiers()
+{
+    mvFrontiers.assign(NUM_CELL_COLORS * NUM_CELL_COLORS, CCellBitset());
+    mvFrontierSizes.assign(NUM_CELL_COLORS * NUM_CELL_COLORS, 0);
+    if (NUM_CELL_COLORS > mvColorCells.size()) { return; }
+
+    CCellBitset lTouched;
+    for (u8 uAggr = 0; NUM_CELL_COLORS > uAggr; ++uAggr)
+    {
+        if (0 == mvColorCounts[uAggr]) { continue; }
+
+        GetNeighborCells(mvColorCells[uAggr], lTouched);
+        for (u8 uVictim = 0; NUM_CELL_COLORS > uVictim; ++uVictim)
+        {
+            if (uAggr == uVictim || 0 == mvColorCounts[uVictim]) { continue; }
+
+            // Colors that don't touch keep an empty (unallocated) set, like pairs that have never met.
+            const u32 c_uSlot = FrontierSlot(PaletteToColor(uAggr), PaletteToColor(uVictim));
+            CCellBitset& lFrontier = mvFrontiers[c_uSlot];
+            lFrontier = lTouched;
+            lFrontier.And(mvColorCells[uVictim]);
+
+            mvFrontierSizes[c_uSlot] = lFrontier.Count();
+            if (0 == mvFrontierSizes[c_uSlot]) { lFrontier = CCellBitset(); }
+        }
+    }
+}
+
+/*!
+ * \brief CBoard::UpdateFrontier
+ *
+ * This method adds or removes a single cell from a color pair's contested set, keeping the set's size in step.
+ *
+ * \param eAggressor - Color doing the attacking.
+ * \param eVictim - Color of the cell.
+ * \param uCellIdx - Index of the cell.
+ * \param bContested - True if the cell touches eAggressor, false if it no longer does.
+ */
+void CBoard::UpdateFrontier(ECellColors eAggressor, ECellColors eVictim, u32 uCellIdx, bool bContested)
+{
+    const u32 c_uSlot = FrontierSlot(eAggressor, eVictim);
+    if (eAggressor == eVictim || mvFrontiers.size() <= c_uSlot) { return; }
+
+    CCellBitset& lFrontier = mvFrontiers[c_uSlot];
+    if (bContested)
+    {
+        if (0 == lFrontier.GetSize()) { lFrontier.Resize(mCellStore.GetCount()); }
+        if (!lFrontier.Test(uCellIdx))
+        {
+            lFrontier.Set(uCellIdx);
+            ++mvFrontierSizes[c_uSlot];
+        }
+    }
+    else if (lFrontier.Test(uCellIdx))
+    {
+        lFrontier.Reset(uCellIdx);
+        --mvFrontierSizes[c_uSlot];
     }
 }
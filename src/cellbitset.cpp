@@ -0,0 +1,286 @@
+#include <QtAlgorithms>
+#include "include/cellbitset.h"
+
+#if !defined(INVALID_CELL_IDX)
+#define INVALID_CELL_IDX (0xffffffff) //!< Returned by cell index lookups when the cell doesn't exist.
+#endif // #if !defined(INVALID_CELL_IDX)
+
+CCellBitset::CCellBitset() : muNumBits{0}
+{
+    // Intentionally left blank.
+}
+
+CCellBitset::CCellBitset(const CCellBitset& aCls) : mvWords{aCls.mvWords}, muNumBits{aCls.muNumBits}
+{
+    // Intentionally left blank.
+}
+
+CCellBitset::CCellBitset(CCellBitset&& aCls) noexcept : mvWords{std::move(aCls.mvWords)}, muNumBits{aCls.muNumBits}
+{
+    aCls.muNumBits = 0;
+}
+
+CCellBitset::~CCellBitset()
+{
+    muNumBits = 0;
+}
+
+CCellBitset& CCellBitset::operator=(const CCellBitset& aCls)
+{
+    if (this != &aCls)
+    {
+        mvWords = aCls.mvWords;
+        muNumBits = aCls.muNumBits;
+    }
+
+    return *this;
+}
+
+CCellBitset& CCellBitset::operator=(CCellBitset&& aCls) noexcept
+{
+    if (this != &aCls)
+    {
+        mvWords = std::move(aCls.mvWords);
+        muNumBits = aCls.muNumBits;
+        aCls.muNumBits = 0;
+    }
+
+    return *this;
+}
+
+/*!
+ * \brief CCellBitset::Resize
+ *
+ * This method sizes the set for "uNumBits" cells and empties it.
+ *
+ * \param uNumBits - Number of cells in the set.
+ */
+void CCellBitset::Resize(u32 uNumBits)
+{
+    muNumBits = uNumBits;
+    mvWords.assign((static_cast<size_t>(uNumBits) + WORD_SZ - 1) / WORD_SZ, 0);
+}
+
+void CCellBitset::Clear()
+{
+    std::fill(mvWords.begin(), mvWords.end(), 0);
+}
+
+void CCellBitset::Set(u32 uIdx)
+{
+    if (muNumBits > uIdx) { mvWords[uIdx / WORD_SZ] |= (1ULL << (uIdx % WORD_SZ)); }
+}
+
+void CCellBitset::Reset(u32 uIdx)
+{
+    if (muNumBits > uIdx) { mvWords[uIdx / WORD_SZ] &= ~(1ULL << (uIdx % WORD_SZ)); }
+}
+
+bool CCellBitset::Test(u32 uIdx) const
+{
+    return (muNumBits > uIdx) ? (0 != (mvWords[uIdx / WORD_SZ] & (1ULL << (uIdx % WORD_SZ)))) : false;
+}
+
+void CCellBitset::And(const CCellBitset& aOther)
+{
+    const size_t c_uNumWords = std::min(mvWords.size(), aOther.mvWords.size());
+    for (size_t uIdx = 0; c_uNumWords > uIdx; ++uIdx) { mvWords[uIdx] &= aOther.mvWords[uIdx]; }
+    for (size_t uIdx = c_uNumWords; mvWords.size() > uIdx; ++uIdx) { mvWords[uIdx] = 0; }
+}
+
+void CCellBitset::Or(const CCellBitset& aOther)
+{
+    const size_t c_uNumWords = std::min(mvWords.size(), aOther.mvWords.size());
+    for (size_t uIdx = 0; c_uNumWords > uIdx; ++uIdx) { mvWords[uIdx] |= aOther.mvWords[uIdx]; }
+}
+
+void CCellBitset::AndNot(const CCellBitset& aOther)
+{
+    const size_t c_uNumWords = std::min(mvWords.size(), aOther.mvWords.size());
+    for (size_t uIdx = 0; c_uNumWords > uIdx; ++uIdx) { mvWords[uIdx] &= ~aOther.mvWords[uIdx]; }
+}
+
+/*!
+ * \brief CCellBitset::OrShifted
+ *
+ * This method ORs in "aSrc AND aMask" moved by "iShift" cells, so cell "i" of the source lands on cell "i + iShift". With the mask limited to cells whose neighbor
+ * in some direction exists, and the shift being that direction's index offset, this marks the neighbors of every source cell in that direction.
+ *
+ * The shift is split into a whole-word part and a bit part, then each destination word is built from (at most) two source words in two plain passes.
+ *
+ * \param aSrc - Cells to move.
+ * \param aMask - Cells of aSrc allowed to move (anything moving off the board must be masked out).
+ * \param iShift - Number of cells to move by (negative moves towards index 0).
+ */
+void CCellBitset::OrShifted(const CCellBitset& aSrc, const CCellBitset& aMask, s32 iShift)
+{
+    const s64 c_iNumWords = static_cast<s64>(std::min(mvWords.size(), std::min(aSrc.mvWords.size(), aMask.mvWords.size())));
+    const s64 c_iWordShift = (0 <= iShift) ? (iShift / WORD_SZ) : -((static_cast<s64>(-iShift) + WORD_SZ - 1) / WORD_SZ);
+    const u32 c_uBitShift = static_cast<u32>(iShift - c_iWordShift * WORD_SZ);
+
+    u64* pDst = mvWords.data();
+    const u64* pSrc = aSrc.mvWords.data();
+    const u64* pMask = aMask.mvWords.data();
+
+    // Low part: source word "j - c_iWordShift" shifted up into destination word "j".
+    const s64 c_iLoStart = std::max<s64>(0, c_iWordShift);
+    const s64 c_iLoEnd = std::min<s64>(c_iNumWords, c_iNumWords + c_iWordShift);
+    for (s64 iIdx = c_iLoStart; c_iLoEnd > iIdx; ++iIdx)
+    {
+        pDst[iIdx] |= (pSrc[iIdx - c_iWordShift] & pMask[iIdx - c_iWordShift]) << c_uBitShift;
+    }
+
+    // High part: the bits of source word "j - c_iWordShift - 1" that spilled over the word boundary.
+    if (0 != c_uBitShift)
+    {
+        const s64 c_iHiStart = std::max<s64>(0, c_iWordShift + 1);
+        const s64 c_iHiEnd = std::min<s64>(c_iNumWords, c_iNumWords + c_iWordShift + 1);
+        for (s64 iIdx = c_iHiStart; c_iHiEnd > iIdx; ++iIdx)
+        {
+            pDst[iIdx] |= (pSrc[iIdx - c_iWordShift - 1] & pMask[iIdx - c_iWordShift - 1]) >> (WORD_SZ - c_uBitShift);
+        }
+    }
+}
+
+/*!
+ * \brief CCellBitset::Sample
+ *
+ * This method sets words [uFirstWord, uEndWord) to a random subset of the same words of "aSrc": each cell is kept if a 32-bit hash of it's index (and the seed)
+ * is below "uThreshold", so a threshold of (chance * 2^32) keeps each cell with that chance and 1 << 32 keeps them all.
+ *
+ * Every bit depends only on the seed and it's own index, never on the bits around it, so the inner loop over a word's 64 bits is a straight run of multiplies and
+ * compares with no branches (the compiler can vectorize it) and any split of the word range gives the same result. Disjoint word ranges can be sampled from
+ * different threads.
+ *
+ * The one branch is per word, on purpose: contested sets are sparse (a thin band along a border), so most words have nothing to pick from and skipping their
+ * hashing outright saves far more than a fully branch-free pass over the whole board would.
+ *
+ * \param aSrc - Cells to pick from (the same size as this set).
+ * \param uThreshold - Chance of keeping a cell, out of 2^32.
+ * \param uSeed - Seed of the hash, the same seed always picks the same cells.
+ * \param uFirstWord - First word to sample.
+ * \param uEndWord - One past the last word to sample.
+ */
+void CCellBitset::Sample(const CCellBitset& aSrc, u64 uThreshold, u64 uSeed, u32 uFirstWord, u32 uEndWord)
+{
+    const u32 c_uEndWord = static_cast<u32>(std::min<size_t>(uEndWord, std::min(mvWords.size(), aSrc.mvWords.size())));
+    u64* pDst = mvWords.data();
+    const u64* pSrc = aSrc.mvWords.data();
+
+    for (u32 uWord = uFirstWord; c_uEndWord > uWord; ++uWord)
+    {
+        // Nothing to pick from, don't bother hashing.
+        if (0 == pSrc[uWord])
+        {
+            pDst[uWord] = 0;
+            continue;
+        }
+
+        u64 uKeep = 0;
+        for (u32 uBit = 0; WORD_SZ > uBit; ++uBit)
+        {
+            // SplitMix64 finalizer over the cell index.
+            u64 uHash = uSeed + (static_cast<u64>(uWord) * WORD_SZ + uBit + 1) * 0x9e3779b97f4a7c15ULL;
+            uHash = (uHash ^ (uHash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            uHash = (uHash ^ (uHash >> 27)) * 0x94d049bb133111ebULL;
+            uHash ^= (uHash >> 31);
+
+            uKeep |= static_cast<u64>((uHash >> 32) < uThreshold) << uBit;
+        }
+
+        pDst[uWord] = pSrc[uWord] & uKeep;
+    }
+}
+
+u32 CCellBitset::Count() const
+{
+    u32 uCount = 0;
+    for (std::vector<u64>::const_iterator pWordIter = mvWords.begin(); pWordIter != mvWords.end(); ++pWordIter)
+    {
+        uCount += qPopulationCount(static_cast<quint64>(*pWordIter));
+    }
+
+    return uCount;
+}
+
+bool CCellBitset::Any() const
+{
+    u64 uAny = 0;
+    for (std::vector<u64>::const_iterator pWordIter = mvWords.begin(); pWordIter != mvWords.end(); ++pWordIter) { uAny |= (*pWordIter); }
+
+    return (0 != uAny);
+}
+
+/*!
+ * \brief CCellBitset::FindNext
+ *
+ * This function finds the first cell in the set at or after "uFrom".
+ *
+ * \param uFrom - Index to start looking at.
+ * \return Index of the cell, or INVALID_CELL_IDX if there are none left.
+ */
+u32 CCellBitset::FindNext(u32 uFrom) const
+{
+    if (muNumBits <= uFrom) { return INVALID_CELL_IDX; }
+
+    size_t uWordIdx = uFrom / WORD_SZ;
+    u64 uWord = mvWords[uWordIdx] & (~0ULL << (uFrom % WORD_SZ));
+    while (0 == uWord)
+    {
+        if (mvWords.size() <= ++uWordIdx) { return INVALID_CELL_IDX; }
+        uWord = mvWords[uWordIdx];
+    }
+
+    return static_cast<u32>(uWordIdx * WORD_SZ + qCountTrailingZeroBits(static_cast<quint64>(uWord)));
+}
+
+CCellBitset::CIterator CCellBitset::begin() const
+{
+    return CIterator(this, FindNext(0));
+}
+
+CCellBitset::CIterator CCellBitset::end() const
+{
+    return CIterator(this, INVALID_CELL_IDX);
+}
+
+u32 CCellBitset::GetSize() const
+{
+    return muNumBits;
+}
+
+u32 CCellBitset::GetNumWords() const
+{
+    return static_cast<u32>(mvWords.size());
+}
+
+const u64* CCellBitset::GetWords() const
+{
+    return mvWords.data();
+}
+
+CCellBitset::CIterator::CIterator(const CCellBitset* pSet, u32 uIdx) : mpSet{pSet}, muIdx{uIdx}
+{
+    // Intentionally left blank.
+}
+
+u32 CCellBitset::CIterator::operator*() const
+{
+    return muIdx;
+}
+
+CCellBitset::CIterator& CCellBitset::CIterator::operator++()
+{
+    muIdx = (INVALID_CELL_IDX != muIdx) ? mpSet->FindNext(muIdx + 1) : INVALID_CELL_IDX;
+    return *this;
+}
+
+bool CCellBitset::CIterator::operator==(const CCellBitset::CIterator& aOther) const
+{
+    return (muIdx == aOther.muIdx);
+}
+
+bool CCellBitset::CIterator::operator!=(const CCellBitset::CIterator& aOther) const
+{
+    return (muIdx != aOther.muIdx);
+}
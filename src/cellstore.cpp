@@ -0,0 +1,556 @@
+#include <atomic>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "include/cellstore.h"
+
+CCellStore::CCellStore() : mMin{SHexCoord(0, 0)}, muSpanQ{0}, muSpanR{0}, muCount{0}, mnCellSize{0.0f}, muVersion{0}
+{
+    // Intentionally left blank.
+}
+
+CCellStore::CCellStore(const CCellStore& aCls) : mMin{SHexCoord(0, 0)}, muSpanQ{0}, muSpanR{0}, muCount{0}, mnCellSize{0.0f}, muVersion{0}
+{
+    (*this) = aCls;
+}
+
+CCellStore::CCellStore(CCellStore&& aCls) noexcept : mMin{SHexCoord(0, 0)}, muSpanQ{0}, muSpanR{0}, muCount{0}, mnCellSize{0.0f}, muVersion{0}
+{
+    (*this) = std::move(aCls);
+}
+
+CCellStore::~CCellStore()
+{
+    Destroy();
+}
+
+CCellStore& CCellStore::operator=(const CCellStore& aCls)
+{
+    if (this != &aCls)
+    {
+        FreeTiles();
+
+        mMin = aCls.mMin;
+        muSpanQ = aCls.muSpanQ;
+        muSpanR = aCls.muSpanR;
+        muCount = aCls.muCount;
+        mnCellSize = aCls.mnCellSize;
+        muVersion = aCls.muVersion;
+
+        // The tiles are shared, whichever store writes to one first makes it's own copy (see GetTileForWrite).
+        mvTiles = aCls.mvTiles;
+    }
+
+    return *this;
+}
+
+CCellStore& CCellStore::operator=(CCellStore&& aCls) noexcept
+{
+    if (this != &aCls)
+    {
+        mMin = aCls.mMin;
+        muSpanQ = aCls.muSpanQ;
+        muSpanR = aCls.muSpanR;
+        muCount = aCls.muCount;
+        mnCellSize = aCls.mnCellSize;
+        muVersion = aCls.muVersion;
+
+        mvTiles = std::move(aCls.mvTiles);
+        aCls.Destroy();
+    }
+
+    return *this;
+}
+
+/*!
+ * \brief CCellStore::Create
+ *
+ * This method sizes the store for the given axial bounding box. Every index starts out invalid, white and centered at (0, 0), and no tile is allocated until a
+ * cell inside it is made valid.
+ *
+ * \param aMin - Smallest axial coordinate of the bounding box.
+ * \param uSpanQ - Number of columns in the bounding box.
+ * \param uSpanR - Number of rows in the bounding box.
+ * \param nCellSize - Size of the cells.
+ */
+void CCellStore::Create(const SHexCoord& aMin, u32 uSpanQ, u32 uSpanR, float nCellSize)
+{
+    FreeTiles();
+
+    mMin = aMin;
+    muSpanQ = uSpanQ;
+    muSpanR = uSpanR;
+    muCount = muSpanQ * muSpanR;
+    mnCellSize = nCellSize;
+
+    mvTiles.assign((static_cast<size_t>(muCount) + CELL_TILE_SZ - 1) >> CELL_TILE_SHIFT, nullptr);
+}
+
+/*!
+ * \brief CCellStore::Destroy
+ *
+ * This method empties the store.
+ */
+void CCellStore::Destroy()
+{
+    FreeTiles();
+
+    mMin = SHexCoord(0, 0);
+    muSpanQ = 0;
+    muSpanR = 0;
+    muCount = 0;
+}
+
+/*!
+ * \brief CCellStore::CoordToIndex
+ *
+ * This function converts an axial coordinate into a cell index. The index isn't checked for validity, only that it's inside the bounding box.
+ *
+ * \param aCoord - Axial coordinate.
+ * \return Cell index, or INVALID_CELL_IDX if the coordinate is outside the bounding box.
+ */
+u32 CCellStore::CoordToIndex(const SHexCoord& aCoord)
+{
+    const s32 iCol = aCoord.mQ - mMin.mQ;
+    const s32 iRow = aCoord.mR - mMin.mR;
+    if (0 <= iCol && 0 <= iRow && muSpanQ > static_cast<u32>(iCol) && muSpanR > static_cast<u32>(iRow))
+    {
+        return static_cast<u32>(iRow) * muSpanQ + static_cast<u32>(iCol);
+    }
+
+    return INVALID_CELL_IDX;
+}
+
+/*!
+ * \brief CCellStore::IndexToCoord
+ *
+ * This function converts a cell index back into it's axial coordinate.
+ *
+ * \param uCellIdx - Cell index.
+ * \return Axial coordinate of the index.
+ */
+SHexCoord CCellStore::IndexToCoord(u32 uCellIdx)
+{
+    return (0 < muSpanQ) ? SHexCoord(mMin.mQ + static_cast<s32>(uCellIdx % muSpanQ), mMin.mR + static_cast<s32>(uCellIdx / muSpanQ)) : SHexCoord();
+}
+
+/*!
+ * \brief CCellStore::BuildNeighbors
+ *
+ * This method works out which neighbors of every valid cell are on the board. It only needs redoing when cells are made valid or invalid.
+ */
+void CCellStore::BuildNeighbors()
+{
+    for (u32 uTile = 0; mvTiles.size() > uTile; ++uTile)
+    {
+        if (nullptr == mvTiles[uTile]) { continue; }
+        SCellTile* pTile = GetTileForWrite(uTile << CELL_TILE_SHIFT);
+
+        for (u32 uSlot = 0; CELL_TILE_SZ > uSlot; ++uSlot)
+        {
+            u8 uMask = 0;
+            if (0 != pTile->muValid[uSlot])
+            {
+                const SHexCoord lCoord = IndexToCoord((uTile << CELL_TILE_SHIFT) | uSlot);
+                for (u32 uDir = 0; NUM_HEX_VERTS > uDir; ++uDir)
+                {
+                    if (IsValid(CoordToIndex(lCoord.Neighbor(uDir)))) { uMask |= static_cast<u8>(1 << uDir); }
+                }
+            }
+
+            pTile->muNeighbors[uSlot] = uMask;
+        }
+    }
+}
+
+/*!
+ * \brief CCellStore::GetNeighborIndices
+ *
+ * This function gets the indices of the neighbors of a cell, in direction order.
+ *
+ * \param[in] uCellIdx - Index of the cell.
+ * \param[out] pNeighbors - Receives the neighbor indices, must have room for NUM_HEX_VERTS entries.
+ * \return Number of neighbors written (0 if the cell doesn't exist).
+ */
+u32 CCellStore::GetNeighborIndices(u32 uCellIdx, u32* pNeighbors)
+{
+    const u8 c_uMask = GetNeighborMask(uCellIdx);
+
+    u32 uCount = 0;
+    for (u32 uDir = 0; NUM_HEX_VERTS > uDir; ++uDir)
+    {
+        if (0 != (c_uMask & (1 << uDir))) { pNeighbors[uCount++] = static_cast<u32>(static_cast<s64>(uCellIdx) + GetDirShift(uDir)); }
+    }
+
+    return uCount;
+}
+
+u32 CCellStore::GetCount()
+{
+    return muCount;
+}
+
+u32 CCellStore::GetSpanQ()
+{
+    return muSpanQ;
+}
+
+u32 CCellStore::GetSpanR()
+{
+    return muSpanR;
+}
+
+float CCellStore::GetCellSize()
+{
+    return mnCellSize;
+}
+
+/*!
+ * \brief CCellStore::GetDirShift
+ *
+ * This function returns how far (in cell indices) the neighbor in a given direction is. It's the same for every cell, as indices are row-major over the bounding box.
+ *
+ * \param uDir - Direction (see SHexCoord::Neighbor).
+ * \return Index offset of the neighbor.
+ */
+s32 CCellStore::GetDirShift(u32 uDir)
+{
+    return c_iHexDirQ[uDir % NUM_HEX_VERTS] + c_iHexDirR[uDir % NUM_HEX_VERTS] * static_cast<s32>(muSpanQ);
+}
+
+bool CCellStore::IsValid(u32 uCellIdx)
+{
+    const SCellTile* pTile = GetTile(uCellIdx >> CELL_TILE_SHIFT);
+    return (nullptr != pTile && muCount > uCellIdx) ? (0 != pTile->muValid[uCellIdx & CELL_TILE_MASK]) : false;
+}
+
+SPoint CCellStore::GetCenter(u32 uCellIdx)
+{
+    const SCellTile* pTile = GetTile(uCellIdx >> CELL_TILE_SHIFT);
+    return (nullptr != pTile) ? SPoint(pTile->mnCenterX[uCellIdx & CELL_TILE_MASK], pTile->mnCenterY[uCellIdx & CELL_TILE_MASK]) : SPoint();
+}
+
+ECellColors CCellStore::GetColor(u32 uCellIdx)
+{
+    return PaletteToColor(GetColorIdx(uCellIdx));
+}
+
+u8 CCellStore::GetColorIdx(u32 uCellIdx)
+{
+    const SCellTile* pTile = GetTile(uCellIdx >> CELL_TILE_SHIFT);
+    return (nullptr != pTile) ? pTile->muColor[uCellIdx & CELL_TILE_MASK] : ColorToPalette(Cell_White);
+}
+
+u32 CCellStore::GetComb(u32 uCellIdx)
+{
+    const SCellTile* pTile = GetTile(uCellIdx >> CELL_TILE_SHIFT);
+    return (nullptr != pTile) ? pTile->muComb[uCellIdx & CELL_TILE_MASK] : INVALID_CELL_IDX;
+}
+
+u8 CCellStore::GetNeighborMask(u32 uCellIdx)
+{
+    const SCellTile* pTile = GetTile(uCellIdx >> CELL_TILE_SHIFT);
+    return (nullptr != pTile) ? pTile->muNeighbors[uCellIdx & CELL_TILE_MASK] : 0;
+}
+
+u32 CCellStore::GetNumTiles()
+{
+    return static_cast<u32>(mvTiles.size());
+}
+
+/*!
+ * \brief CCellStore::GetTile
+ *
+ * This function returns a tile for reading, e.g. to stream over the cells in it.
+ *
+ * \param uTile - Index of the tile.
+ * \return The tile, or nullptr if no cell inside it was ever made valid.
+ */
+const SCellTile* CCellStore::GetTile(u32 uTile)
+{
+    return (mvTiles.size() > uTile) ? mvTiles[uTile].get() : nullptr;
+}
+
+/*!
+ * \brief CCellStore::GetVersion
+ *
+ * This function returns the version of the store, which goes up with every write. A tile whose muVersion is at or below a version seen before hasn't changed since.
+ *
+ * \return The current store version.
+ */
+u64 CCellStore::GetVersion()
+{
+    return muVersion;
+}
+
+/*!
+ * \brief CCellStore::Snapshot
+ *
+ * This function takes an immutable snapshot of the store at it's current version. Only the tile table is copied, the tiles themselves are shared until the store
+ * writes to them again. The store doesn't keep the snapshot itself, so once the caller drops it (see CBoard::PublishSnapshot) the tiles go back to being owned by
+ * the store alone and can be written in place.
+ *
+ * \note Must be called from the thread that writes to the store, the returned snapshot can then be read from any thread.
+ *
+ * \return The snapshot.
+ */
+std::shared_ptr<const CCellSnapshot> CCellStore::Snapshot()
+{
+    std::shared_ptr<CCellSnapshot> pSnapshot = std::make_shared<CCellSnapshot>();
+    pSnapshot->mMin = mMin;
+    pSnapshot->muSpanQ = muSpanQ;
+    pSnapshot->muCount = muCount;
+    pSnapshot->muVersion = muVersion;
+    pSnapshot->mvTiles.assign(mvTiles.begin(), mvTiles.end());
+
+    return pSnapshot;
+}
+
+void CCellStore::SetCellSize(float nCellSize)
+{
+    mnCellSize = nCellSize;
+}
+
+void CCellStore::SetValid(u32 uCellIdx, bool bValid)
+{
+    SCellTile* pTile = GetTileForWrite(uCellIdx, bValid);
+    if (nullptr != pTile)
+    {
+        u8& lValid = pTile->muValid[uCellIdx & CELL_TILE_MASK];
+        if ((0 != lValid) != bValid)
+        {
+            lValid = bValid ? 1 : 0;
+            pTile->muNumValid = bValid ? (pTile->muNumValid + 1) : (pTile->muNumValid - 1);
+        }
+    }
+}
+
+void CCellStore::SetCenter(u32 uCellIdx, const SPoint& aCenter)
+{
+    SCellTile* pTile = GetTileForWrite(uCellIdx);
+    if (nullptr != pTile)
+    {
+        pTile->mnCenterX[uCellIdx & CELL_TILE_MASK] = aCenter.mX;
+        pTile->mnCenterY[uCellIdx & CELL_TILE_MASK] = aCenter.mY;
+    }
+}
+
+void CCellStore::SetColor(u32 uCellIdx, ECellColors eClr)
+{
+    SCellTile* pTile = GetTileForWrite(uCellIdx);
+    if (nullptr != pTile) { pTile->muColor[uCellIdx & CELL_TILE_MASK] = ColorToPalette(eClr); }
+}
+
+void CCellStore::SetComb(u32 uCellIdx, u32 uCombIdx)
+{
+    SCellTile* pTile = GetTileForWrite(uCellIdx);
+    if (nullptr != pTile) { pTile->muComb[uCellIdx & CELL_TILE_MASK] = uCombIdx; }
+}
+
+/*!
+ * \brief CCellStore::AssignTile
+ *
+ * This method copies in the state of every cell of a tile at once (e.g. from a board template), allocating the tile. Each array must hold CELL_TILE_SZ entries.
+ * Indices past the end of the store are never valid. Neighbors aren't touched, call "BuildNeighbors" once all tiles are in.
+ *
+ * \param uTile - Index of the tile.
+ * \param pCentersX - Pixel center X of each cell.
+ * \param pCentersY - Pixel center Y of each cell.
+ * \param pColors - Palette index of each cell's color.
+ * \param pValidity - Non-zero for each index that's an actual cell.
+ */
+void CCellStore::AssignTile(u32 uTile, const float* pCentersX, const float* pCentersY, const u8* pColors, const u8* pValidity)
+{
+    SCellTile* pTile = GetTileForWrite(uTile << CELL_TILE_SHIFT, true);
+    if (nullptr == pTile) { return; }
+
+    const u32 c_uNum = std::min<u32>(CELL_TILE_SZ, muCount - (uTile << CELL_TILE_SHIFT));
+    std::copy(pCentersX, pCentersX + CELL_TILE_SZ, pTile->mnCenterX);
+    std::copy(pCentersY, pCentersY + CELL_TILE_SZ, pTile->mnCenterY);
+
+    pTile->muNumValid = 0;
+    for (u32 uSlot = 0; CELL_TILE_SZ > uSlot; ++uSlot)
+    {
+        pTile->muColor[uSlot] = (NUM_CELL_COLORS > pColors[uSlot]) ? pColors[uSlot] : ColorToPalette(Cell_White);
+        pTile->muValid[uSlot] = (c_uNum > uSlot && 0 != pValidity[uSlot]) ? 1 : 0;
+        pTile->muNumValid += pTile->muValid[uSlot];
+    }
+}
+
+/*!
+ * \brief CCellStore::GetTileForWrite
+ *
+ * This function finds the tile holding a cell and stamps it with a new store version, as the caller is about to change it. A tile that's still referenced
+ * elsewhere (e.g. by a published snapshot) is copied first, one that isn't is written in place.
+ *
+ * \param uCellIdx - Index of the cell.
+ * \param bAllocate - Allocate the tile if it doesn't exist yet.
+ * \return The tile, or nullptr if the index is out of range (or the tile doesn't exist and bAllocate is false).
+ */
+SCellTile* CCellStore::GetTileForWrite(u32 uCellIdx, bool bAllocate)
+{
+    if (muCount <= uCellIdx) { return nullptr; }
+
+    std::shared_ptr<SCellTile>& pTile = mvTiles[uCellIdx >> CELL_TILE_SHIFT];
+    if (nullptr == pTile && bAllocate)
+    {
+        pTile = std::make_shared<SCellTile>();
+        std::fill(pTile->muColor, pTile->muColor + CELL_TILE_SZ, ColorToPalette(Cell_White));
+        std::fill(pTile->muComb, pTile->muComb + CELL_TILE_SZ, INVALID_CELL_IDX);
+    }
+    else if (nullptr != pTile && 1 < pTile.use_count())
+    {
+        // Someone else (a snapshot or a copy of the store) still sees this tile, leave them the old one.
+        pTile = std::make_shared<SCellTile>(*pTile);
+    }
+    else if (nullptr != pTile)
+    {
+        // The count is read relaxed, so on it's own it doesn't order the reads of whoever dropped the last other reference before our writes. Dropping a
+        // reference is a release, pairing it with an acquire fence here makes sure that reader is done with the tile before it's written in place.
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    if (nullptr != pTile) { pTile->muVersion = ++muVersion; }
+
+    return pTile.get();
+}
+
+void CCellStore::FreeTiles()
+{
+    mvTiles.clear();
+}
+
+/*!
+ * \brief CCellStore::PointsInCells
+ *
+ * This method tests a batch of points against a batch of cells, point "i" against cell pCellIdxs[i], with the same exact test as CCell::PointInHex. Points are
+ * handled in fixed-size blocks: the offsets from each cell's center are gathered into contiguous arrays first (straight out of the tile, which is only looked up
+ * again when the tile changes), then the containment test runs over the whole block. With SSE2 the test is done four points at a time with explicit intrinsics,
+ * otherwise it's a plain branch-free loop over HexContains.
+ *
+ * \param[in] pPointsX - X of each point.
+ * \param[in] pPointsY - Y of each point.
+ * \param[in] pCellIdxs - Cell to test each point against (invalid cells never contain anything).
+ * \param[in] uCount - Number of points.
+ * \param[out] pInside - Set to 1 for each point inside it's cell, 0 otherwise.
+ */
+void CCellStore::PointsInCells(const float* pPointsX, const float* pPointsY, const u32* pCellIdxs, u32 uCount, u8* pInside)
+{
+    static const u32 c_uBlockSz = 64;
+    const float c_nRadius = mnCellSize / 2.0f;
+    const float c_nFar = 2.0f * c_nRadius + 1.0f; // Offset used for invalid cells, it's outside any hexagon.
+
+    alignas(16) float nDX[c_uBlockSz];
+    alignas(16) float nDY[c_uBlockSz];
+
+    u32 uTileIdx = INVALID_CELL_IDX;
+    const SCellTile* pTile = nullptr;
+    for (u32 uStart = 0; uCount > uStart; uStart += c_uBlockSz)
+    {
+        const u32 c_uNum = std::min(c_uBlockSz, uCount - uStart);
+
+        // Gather (the tail of a short block is padded out so the test always runs over a full block).
+        for (u32 uIdx = 0; c_uNum > uIdx; ++uIdx)
+        {
+            const u32 c_uCellIdx = pCellIdxs[uStart + uIdx];
+            if ((c_uCellIdx >> CELL_TILE_SHIFT) != uTileIdx)
+            {
+                uTileIdx = c_uCellIdx >> CELL_TILE_SHIFT;
+                pTile = (mvTiles.size() > uTileIdx) ? mvTiles[uTileIdx].get() : nullptr;
+            }
+
+            const u32 c_uSlot = c_uCellIdx & CELL_TILE_MASK;
+            const bool c_bValid = (nullptr != pTile) && (muCount > c_uCellIdx) && (0 != pTile->muValid[c_uSlot]);
+            nDX[uIdx] = c_bValid ? (pPointsX[uStart + uIdx] - pTile->mnCenterX[c_uSlot]) : c_nFar;
+            nDY[uIdx] = c_bValid ? (pPointsY[uStart + uIdx] - pTile->mnCenterY[c_uSlot]) : c_nFar;
+        }
+
+        std::fill(nDX + c_uNum, nDX + c_uBlockSz, c_nFar);
+        std::fill(nDY + c_uNum, nDY + c_uBlockSz, c_nFar);
+
+        // Test.
+#if defined(__SSE2__)
+        // Same math as HexContains: fold into the first quadrant (clear the sign bits), then check the vertical and the slanted edge.
+        const __m128 c_vAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const __m128 c_vHalfWidth = _mm_set1_ps(c_nHexHalfSqrt3 * c_nRadius);
+        const __m128 c_vInvSqrt3 = _mm_set1_ps(c_nHexInvSqrt3);
+        const __m128 c_vRadius = _mm_set1_ps(c_nRadius);
+        for (u32 uIdx = 0; c_uNum > uIdx; uIdx += 4)
+        {
+            const __m128 vDX = _mm_and_ps(_mm_load_ps(nDX + uIdx), c_vAbsMask);
+            const __m128 vDY = _mm_and_ps(_mm_load_ps(nDY + uIdx), c_vAbsMask);
+            const __m128 vInside = _mm_and_ps(_mm_cmple_ps(vDX, c_vHalfWidth), _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(vDX, c_vInvSqrt3), vDY), c_vRadius));
+
+            const int iMask = _mm_movemask_ps(vInside);
+            const u32 c_uLanes = std::min(4u, c_uNum - uIdx);
+            for (u32 uLane = 0; c_uLanes > uLane; ++uLane)
+            {
+                pInside[uStart + uIdx + uLane] = static_cast<u8>((iMask >> uLane) & 1);
+            }
+        }
+#else
+        for (u32 uIdx = 0; c_uNum > uIdx; ++uIdx)
+        {
+            pInside[uStart + uIdx] = static_cast<u8>(HexContains(nDX[uIdx], nDY[uIdx], c_nRadius));
+        }
+#endif
+    }
+}
+
+CCellSnapshot::CCellSnapshot() : mMin{SHexCoord(0, 0)}, muSpanQ{0}, muCount{0}, muVersion{0}
+{
+    // Intentionally left blank.
+}
+
+CCellSnapshot::~CCellSnapshot()
+{
+    mvTiles.clear();
+}
+
+SHexCoord CCellSnapshot::IndexToCoord(u32 uCellIdx) const
+{
+    return (0 < muSpanQ) ? SHexCoord(mMin.mQ + static_cast<s32>(uCellIdx % muSpanQ), mMin.mR + static_cast<s32>(uCellIdx / muSpanQ)) : SHexCoord();
+}
+
+u32 CCellSnapshot::GetCount() const
+{
+    return muCount;
+}
+
+u64 CCellSnapshot::GetVersion() const
+{
+    return muVersion;
+}
+
+u32 CCellSnapshot::GetNumTiles() const
+{
+    return static_cast<u32>(mvTiles.size());
+}
+
+const SCellTile* CCellSnapshot::GetTile(u32 uTile) const
+{
+    return (mvTiles.size() > uTile) ? mvTiles[uTile].get() : nullptr;
+}
+
+bool CCellSnapshot::IsValid(u32 uCellIdx) const
+{
+    const SCellTile* pTile = GetTile(uCellIdx >> CELL_TILE_SHIFT);
+    return (nullptr != pTile && muCount > uCellIdx) ? (0 != pTile->muValid[uCellIdx & CELL_TILE_MASK]) : false;
+}
+
+SPoint CCellSnapshot::GetCenter(u32 uCellIdx) const
+{
+    const SCellTile* pTile = GetTile(uCellIdx >> CELL_TILE_SHIFT);
+    return (nullptr != pTile) ? SPoint(pTile->mnCenterX[uCellIdx & CELL_TILE_MASK], pTile->mnCenterY[uCellIdx & CELL_TILE_MASK]) : SPoint();
+}
+
+ECellColors CCellSnapshot::GetColor(u32 uCellIdx) const
+{
+    return PaletteToColor(GetColorIdx(uCellIdx));
+}
+
+u8 CCellSnapshot::GetColorIdx(u32 uCellIdx) const
+{
+    const SCellTile* pTile = GetTile(uCellIdx >> CELL_TILE_SHIFT);
+    return (nullptr != pTile) ? pTile->muColor[uCellIdx & CELL_TILE_MASK] : ColorToPalette(Cell_White);
+}
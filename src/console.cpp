@@ -128,6 +128,10 @@ SCommand ParseCommandString(QString lStr, std::string sSender, u32 uSenderID)
     {
         lCmd.meCmd = Cmd_NewGame;
     }
+    else if (0 == lCmdStr.compare("!odds", Qt::CaseInsensitive))
+    {
+        lCmd.meCmd = Cmd_Odds;
+    }
     else if (0 == lCmdStr.compare("!redraw", Qt::CaseInsensitive))
     {
         lCmd.meCmd = Cmd_Redraw;
@@ -0,0 +1,331 @@
+#include "include/distancefield.h"
+
+CDistanceFields::CDistanceFields() : mpStore{nullptr}
+{
+    // Intentionally left blank.
+}
+
+CDistanceFields::CDistanceFields(const CDistanceFields& aCls) : mpStore{nullptr}
+{
+    (*this) = aCls;
+}
+
+CDistanceFields::~CDistanceFields()
+{
+    Destroy();
+}
+
+CDistanceFields& CDistanceFields::operator=(const CDistanceFields& aCls)
+{
+    if (this != &aCls)
+    {
+        mpStore = aCls.mpStore;
+        mvFields = aCls.mvFields;
+        mvPending = aCls.mvPending;
+        mvMarks = aCls.mvMarks;
+    }
+
+    return *this;
+}
+
+/*!
+ * \brief CDistanceFields::Build
+ *
+ * This method sets the fields up for a board. No field is computed here, each one is computed the first time it's asked for.
+ *
+ * \param pStore - Cell store of the board.
+ */
+void CDistanceFields::Build(CCellStore* pStore)
+{
+    mpStore = pStore;
+    mvFields.assign(NUM_CELL_COLORS, std::vector<u32>());
+    mvPending.assign(NUM_CELL_COLORS, std::vector<u32>());
+    mvMarks.clear();
+}
+
+/*!
+ * \brief CDistanceFields::Destroy
+ *
+ * This method drops every field.
+ */
+void CDistanceFields::Destroy()
+{
+    mpStore = nullptr;
+    mvFields.clear();
+    mvPending.clear();
+    mvBuckets.clear();
+    mvAffected.clear();
+    mvMarks.clear();
+    mvCheck.clear();
+}
+
+/*!
+ * \brief CDistanceFields::CellRecolored
+ *
+ * This method queues a recolored cell on the fields of it's old and new colors, they're repaired the next time they're read. Fields that haven't been built yet
+ * don't need to hear about it.
+ *
+ * \param uCellIdx - Index of the cell.
+ * \param eOldClr - Color the cell had.
+ * \param eNewClr - Color the cell has now.
+ */
+void CDistanceFields::CellRecolored(u32 uCellIdx, ECellColors eOldClr, ECellColors eNewClr)
+{
+    const u8 c_aClrs[2] = { ColorToPalette(eOldClr), ColorToPalette(eNewClr) };
+    for (u8 uClr : c_aClrs)
+    {
+        if (mvFields.size() <= uClr || mvFields[uClr].empty()) { continue; }
+
+        // A field that has fallen this far behind is cheaper to recompute than to repair.
+        if (mvFields[uClr].size() <= mvPending[uClr].size())
+        {
+            mvFields[uClr].clear();
+            mvPending[uClr].clear();
+            continue;
+        }
+
+        mvPending[uClr].push_back(uCellIdx);
+    }
+}
+
+/*!
+ * \brief CDistanceFields::GetDistance
+ *
+ * This function returns how many steps a cell is from the nearest cell of a color.
+ *
+ * \param eClr - Color to measure from.
+ * \param uCellIdx - Index of the cell.
+ * \return Distance in cells (0 if the cell has the color), DISTANCE_UNREACHED if the cell doesn't exist or the color has no cells.
+ */
+u32 CDistanceFields::GetDistance(ECellColors eClr, u32 uCellIdx)
+{
+    const u8 c_uClr = ColorToPalette(eClr);
+    return (Refresh(c_uClr) && mvFields[c_uClr].size() > uCellIdx) ? mvFields[c_uClr][uCellIdx] : DISTANCE_UNREACHED;
+}
+
+/*!
+ * \brief CDistanceFields::GetField
+ *
+ * This function returns the whole distance field of a color, by cell index.
+ *
+ * \note The view is only good until the next recolor.
+ *
+ * \param eClr - Color to measure from.
+ * \return Distance of every cell from the color, an empty view if there's no board.
+ */
+CSpan<const u32> CDistanceFields::GetField(ECellColors eClr)
+{
+    const u8 c_uClr = ColorToPalette(eClr);
+    return Refresh(c_uClr) ? CSpan<const u32>(mvFields[c_uClr].data(), mvFields[c_uClr].size()) : CSpan<const u32>();
+}
+
+/*!
+ * \brief CDistanceFields::ComputeField
+ *
+ * This method computes a field from scratch.
+ */
+void CDistanceFields::ComputeField(u8 uClr)
+{
+    SearchField(uClr, mvFields[uClr]);
+    mvPending[uClr].clear();
+}
+
+/*!
+ * \brief CDistanceFields::SearchField
+ *
+ * This method fills a field with a breadth-first search seeded from every cell of the color at once.
+ *
+ * \param uClr - Palette index of the color.
+ * \param vField - Field to fill.
+ */
+void CDistanceFields::SearchField(u8 uClr, std::vector<u32>& vField)
+{
+    const u32 c_uNumCells = mpStore->GetCount();
+    vField.assign(c_uNumCells, DISTANCE_UNREACHED);
+
+    if (mvBuckets.empty()) { mvBuckets.resize(1); }
+    for (u32 uCellIdx = 0; c_uNumCells > uCellIdx; ++uCellIdx)
+    {
+        if (mpStore->IsValid(uCellIdx) && uClr == mpStore->GetColorIdx(uCellIdx))
+        {
+            vField[uCellIdx] = 0;
+            mvBuckets[0].push_back(uCellIdx);
+        }
+    }
+
+    Propagate(vField);
+}
+
+/*!
+ * \brief CDistanceFields::RepairField
+ *
+ * This method brings a field up to date with the cells recolored since it was last read.
+ *
+ * Cells that lost the color are handled first, against the old distances: going out from them in distance order, a cell is affected if every neighbor one step
+ * closer to the color is affected too (it's shortest paths all ran through a lost cell). Only the affected cells are reset, each restarting from it's best
+ * unaffected neighbor. Cells that gained the color restart at 0, and a single distance-ordered pass then settles everything that changed.
+ */
+void CDistanceFields::RepairField(u8 uClr)
+{
+    std::vector<u32>& vField = mvFields[uClr];
+    std::vector<u32>& vPending = mvPending[uClr];
+    u32 pNeighbors[NUM_HEX_VERTS];
+
+    if (mvMarks.size() != vField.size()) { mvMarks.assign(vField.size(), 0); }
+
+    // Find everything that depended on a lost cell.
+    mvAffected.clear();
+    for (std::vector<u32>::iterator pCellIter = vPending.begin(); pCellIter != vPending.end(); ++pCellIter)
+    {
+        if (0 == vField[*pCellIter] && uClr != mpStore->GetColorIdx(*pCellIter) && 0 == mvMarks[*pCellIter])
+        {
+            mvMarks[*pCellIter] = 1;
+            mvAffected.push_back(*pCellIter);
+        }
+    }
+
+    for (size_t uHead = 0; mvAffected.size() > uHead; ++uHead)
+    {
+        const u32 c_uDist = vField[mvAffected[uHead]];
+        const u32 c_uNumNeighbors = mpStore->GetNeighborIndices(mvAffected[uHead], pNeighbors);
+        for (u32 uNeigh = 0; c_uNumNeighbors > uNeigh; ++uNeigh)
+        {
+            const u32 c_uChildIdx = pNeighbors[uNeigh];
+            if (0 != mvMarks[c_uChildIdx] || c_uDist + 1 != vField[c_uChildIdx] || uClr == mpStore->GetColorIdx(c_uChildIdx)) { continue; }
+
+            // Still reachable at the same distance through someone else?
+            u32 pParents[NUM_HEX_VERTS];
+            const u32 c_uNumParents = mpStore->GetNeighborIndices(c_uChildIdx, pParents);
+            bool bSupported = false;
+            for (u32 uParent = 0; c_uNumParents > uParent && !bSupported; ++uParent)
+            {
+                bSupported = (0 == mvMarks[pParents[uParent]] && c_uDist == vField[pParents[uParent]]);
+            }
+
+            if (!bSupported)
+            {
+                mvMarks[c_uChildIdx] = 1;
+                mvAffected.push_back(c_uChildIdx);
+            }
+        }
+    }
+
+    // Reset them, then restart them (and the gained cells) from what's left.
+    for (std::vector<u32>::iterator pCellIter = mvAffected.begin(); pCellIter != mvAffected.end(); ++pCellIter) { vField[*pCellIter] = DISTANCE_UNREACHED; }
+
+    if (mvBuckets.empty()) { mvBuckets.resize(1); }
+    for (std::vector<u32>::iterator pCellIter = vPending.begin(); pCellIter != vPending.end(); ++pCellIter)
+    {
+        if (0 != vField[*pCellIter] && uClr == mpStore->GetColorIdx(*pCellIter))
+        {
+            vField[*pCellIter] = 0;
+            mvBuckets[0].push_back(*pCellIter);
+        }
+    }
+
+    for (std::vector<u32>::iterator pCellIter = mvAffected.begin(); pCellIter != mvAffected.end(); ++pCellIter)
+    {
+        mvMarks[*pCellIter] = 0;
+        if (0 == vField[*pCellIter]) { continue; }
+
+        u32 uBest = DISTANCE_UNREACHED;
+        const u32 c_uNumNeighbors = mpStore->GetNeighborIndices(*pCellIter, pNeighbors);
+        for (u32 uNeigh = 0; c_uNumNeighbors > uNeigh; ++uNeigh)
+        {
+            if (DISTANCE_UNREACHED != vField[pNeighbors[uNeigh]] && uBest > vField[pNeighbors[uNeigh]] + 1) { uBest = vField[pNeighbors[uNeigh]] + 1; }
+        }
+
+        if (DISTANCE_UNREACHED != uBest)
+        {
+            vField[*pCellIter] = uBest;
+            if (mvBuckets.size() <= uBest) { mvBuckets.resize(uBest + 1); }
+            mvBuckets[uBest].push_back(*pCellIter);
+        }
+    }
+
+    Propagate(vField);
+    vPending.clear();
+
+#if defined(DISTANCE_CHECK_REPAIRS)
+    CheckField(uClr);
+#endif // #if defined(DISTANCE_CHECK_REPAIRS)
+}
+
+/*!
+ * \brief CDistanceFields::CheckField
+ *
+ * This method checks a repaired field against the same field searched from scratch and reports the first cell they disagree on. The repaired field is left as
+ * it is, so the bad distances stay visible to whatever reads them next.
+ *
+ * \param uClr - Palette index of the color.
+ */
+void CDistanceFields::CheckField(u8 uClr)
+{
+    SearchField(uClr, mvCheck);
+
+    const std::pair<std::vector<u32>::iterator, std::vector<u32>::iterator> c_Mismatch = std::mismatch(mvFields[uClr].begin(), mvFields[uClr].end(), mvCheck.begin());
+    if (c_Mismatch.first != mvFields[uClr].end())
+    {
+        qCritical("ASSERT ERROR: Repaired distance field of %s doesn't match a fresh search! (cell %u: %u, should be %u)", c_ColorPalette[uClr].pName,
+                  static_cast<u32>(c_Mismatch.first - mvFields[uClr].begin()), *c_Mismatch.first, *c_Mismatch.second);
+    }
+}
+
+/*!
+ * \brief CDistanceFields::Propagate
+ *
+ * This method settles a field from the queued cells, nearest first. A queued cell whose distance has since dropped is skipped, it was queued again further down.
+ *
+ * \param vField - Field to settle.
+ */
+void CDistanceFields::Propagate(std::vector<u32>& vField)
+{
+    u32 pNeighbors[NUM_HEX_VERTS];
+    for (u32 uDist = 0; mvBuckets.size() > uDist; ++uDist)
+    {
+        if (mvBuckets[uDist].empty()) { continue; }
+        if (mvBuckets.size() <= uDist + 1) { mvBuckets.resize(uDist + 2); }
+
+        std::vector<u32>& vBucket = mvBuckets[uDist];
+        std::vector<u32>& vNext = mvBuckets[uDist + 1];
+        for (std::vector<u32>::iterator pCellIter = vBucket.begin(); pCellIter != vBucket.end(); ++pCellIter)
+        {
+            if (uDist != vField[*pCellIter]) { continue; }
+
+            const u32 c_uNumNeighbors = mpStore->GetNeighborIndices(*pCellIter, pNeighbors);
+            for (u32 uNeigh = 0; c_uNumNeighbors > uNeigh; ++uNeigh)
+            {
+                if (uDist + 1 < vField[pNeighbors[uNeigh]])
+                {
+                    vField[pNeighbors[uNeigh]] = uDist + 1;
+                    vNext.push_back(pNeighbors[uNeigh]);
+                }
+            }
+        }
+
+        vBucket.clear();
+    }
+}
+
+/*!
+ * \brief CDistanceFields::Refresh
+ *
+ * This function makes sure a color's field exists and is up to date.
+ *
+ * \return True if the field can be read, false if there's no such color or no board.
+ */
+bool CDistanceFields::Refresh(u8 uClr)
+{
+    if (nullptr == mpStore || mvFields.size() <= uClr) { return false; }
+
+    if (mvFields[uClr].empty())
+    {
+        ComputeField(uClr);
+    }
+    else if (!mvPending[uClr].empty())
+    {
+        RepairField(uClr);
+    }
+
+    return true;
+}
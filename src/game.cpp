@@ -1,29 +1,19 @@
 ﻿#include "include/game.h"
-
-std::map<std::string, ECellColors> g_NameToColorMap = {
-    std::pair<std::string, ECellColors>("White", Cell_White),
-    std::pair<std::string, ECellColors>("Red", Cell_Red),
-    std::pair<std::string, ECellColors>("Orange", Cell_Orange),
-    std::pair<std::string, ECellColors>("Yellow", Cell_Yellow),
-    std::pair<std::string, ECellColors>("Lime", Cell_Lime),
-    std::pair<std::string, ECellColors>("Green", Cell_Green),
-    std::pair<std::string, ECellColors>("Cyan", Cell_Cyan),
-    std::pair<std::string, ECellColors>("Blue", Cell_Blue),
-    std::pair<std::string, ECellColors>("Purple", Cell_Purple),
-    std::pair<std::string, ECellColors>("Magenta", Cell_Magenta),
-    std::pair<std::string, ECellColors>("Pink", Cell_Pink),
-    std::pair<std::string, ECellColors>("Brown", Cell_Brown),
-    std::pair<std::string, ECellColors>("Gray", Cell_Gray)
-};
+#include "include/autoplay.h"
+#include "include/simulator.h"
 
 // ================================ Begin CDice Implementation ================================ //
-CDice::CDice() : muLastRoll{0}
+CDice::CDice() : muLastRoll{0}, mEngine{static_cast<u32>(clock())}
 {
-    // Seed the RNG.
-    srand(static_cast<u32>(clock()));
+    // Intentionally left blank.
 }
 
-CDice::CDice(const CDice&aCls) : muLastRoll{aCls.muLastRoll}
+CDice::CDice(u32 uSeed) : muLastRoll{0}, mEngine{uSeed}
+{
+    // Intentionally left blank.
+}
+
+CDice::CDice(const CDice&aCls) : muLastRoll{aCls.muLastRoll}, mEngine{aCls.mEngine}
 {
     // Intentionally left blank.
 }
@@ -36,12 +26,13 @@ CDice::~CDice()
 CDice& CDice::operator=(const CDice& aCls)
 {
     muLastRoll = aCls.muLastRoll;
+    mEngine = aCls.mEngine;
     return *this;
 }
 
 u32 CDice::Roll(u32 uMin, u32 uMax)
 {
-    u32 uRoll = floor(rand());
+    u32 uRoll = mEngine() >> 1; // 31 bits, the same range rand() gives.
     if (uRoll > uMax)
     {
         muLastRoll = (uMax > 0) ? (uRoll % uMax) + uMin : static_cast<u32>(uRoll);
@@ -63,7 +54,7 @@ u32 CDice::GetLastRoll()
 
 // ================================ Begin CGame Implementation ================================ //
 CGame::CGame(QObject *pParent) : QObject{pParent}, mbGamePlaying{false}, mCenter{SPoint(0,0)}, muCellSz{0}, mpDice{nullptr}, mpBoard{nullptr},
-    mpCanvas{nullptr}, muDiceMax{0xffffffff}, msTmpFileName{"colorwars_development.png"}, mpNetServer{nullptr}, mpNetClient{nullptr}, mpTicker{nullptr}
+    mpAutoPlayer{nullptr}, mpOdds{nullptr}, mpCanvas{nullptr}, muDiceMax{0xffffffff}, msTmpFileName{"colorwars_development.png"}, muSyncVersion{0}, mpNetServer{nullptr}, mpNetClient{nullptr}, mpTicker{nullptr}
 {
     if (msTmpFileName.find("_DEBUG") == std::string::npos && g_cfgVars.mbIsDebug)
     {
@@ -73,6 +64,8 @@ CGame::CGame(QObject *pParent) : QObject{pParent}, mbGamePlaying{false}, mCenter
 
 CGame::~CGame()
 {
+    if (nullptr != mpAutoPlayer) { delete mpAutoPlayer; }
+    if (nullptr != mpOdds) { delete mpOdds; }
     if (nullptr != mpDice) { delete mpDice; }
     if (nullptr != mpBoard)
     {
@@ -96,8 +89,9 @@ void CGame::SetupGame(u32 iDiceMax, u32 uCellSz, SPoint qCenter)
         // Instantiate a new CDice object.
         mpDice = new CDice();
 
-        // Instantiate a new board.
+        // Instantiate a new board, caching generated boards next to the logs.
         mpBoard = new CBoard();
+        mpBoard->SetTemplateDir(QString::fromStdString(g_cfgVars.msRootDir + "/cache"));
 
         qInfo("Game has been successfully setup!");
     }
@@ -165,52 +159,17 @@ void CGame::Play(ECellColors eAggressor, ECellColors eVictim)
 {
     if (nullptr != mpDice && nullptr != mpBoard && nullptr == mpNetClient)
     {
-        /* Determine the ranges we need to be in for movement amounts.
-         * These are:
-         *  [x - y](25% of range){center of range}  --->  Move 3 spaces
-         *  [x - y](10% of range){center of range}  --->  Move 6 spaces
-         *  [x - y](5% of range){center of range}   --->  Move 9 spaces
-         *  [x - y](1% of range){center of range}   --->  Overtake
-         */
         const u32 uSmallMvRange = static_cast<u32>(muDiceMax * 0.25f);
-        const u32 uMedMvRange = static_cast<u32>(muDiceMax * 0.10f);
-        const u32 uLrgMvRange = static_cast<u32>(muDiceMax * 0.05f);
         const u32 uMidOfRange = static_cast<u32>(muDiceMax / 2.0f);
 
         // Roll the dice!
         u32 uRoll = mpDice->Roll(3, muDiceMax);
 
         // Check to see if we should move.
-        if ((uSmallMvRange + uMidOfRange) >= uRoll && (uMidOfRange - uSmallMvRange) <= uRoll)
+        u32 uMvAmnt = 0;
+        if (RollToMove(uRoll, muDiceMax, uMvAmnt))
         {
-            std::pair<bool, QString> rtnData;
-            if ((uMedMvRange + uMidOfRange) >= uRoll && (uMidOfRange - uMedMvRange) <= uRoll)
-            {
-                if ((uLrgMvRange + uMidOfRange) >= uRoll && (uMidOfRange - uLrgMvRange) <= uRoll)
-                {
-                    if (uMidOfRange == uRoll)
-                    {
-                        // Overtake! Move HUGE amount!
-                        rtnData = MoveColor(eAggressor, eVictim, 0);
-                    }
-                    else
-                    {
-                        // Move large amount!
-                        rtnData = MoveColor(eAggressor, eVictim, 7);
-                    }
-                }
-                else
-                {
-                    // Move medium amount!
-                    rtnData = MoveColor(eAggressor, eVictim, 5);
-                }
-            }
-            else
-            {
-                // Move small amount!
-                rtnData = MoveColor(eAggressor, eVictim, 3);
-            }
-
+            std::pair<bool, QString> rtnData = MoveColor(eAggressor, eVictim, uMvAmnt);
             if (rtnData.first)
             {
                 qInfo("%s", rtnData.second.toStdString().c_str());
@@ -218,22 +177,7 @@ void CGame::Play(ECellColors eAggressor, ECellColors eVictim)
                 rtnData.second.prepend("[Info]: ");
                 if (nullptr != mpNetServer)
                 {
-                    // Update the client boards.
-                    std::map<u64, ECellColors> mBoardMap;
-                    std::map<u64, CCell*> mCellMap = mpBoard->GetCellMap();
-
-                    for (std::map<u64,CCell*>::iterator pIter = mCellMap.begin(); pIter != mCellMap.end(); ++pIter)
-                    {
-                        std::pair<u64,CCell*> lMappedCell = (*pIter);
-
-                        if (nullptr != lMappedCell.second && mmOldBoardMap[lMappedCell.first] != lMappedCell.second->GetColor())
-                        {
-                            mBoardMap.insert(std::pair<u64, ECellColors>(lMappedCell.first, lMappedCell.second->GetColor()));
-                            mmOldBoardMap[lMappedCell.first] = lMappedCell.second->GetColor();
-                        }
-                    }
-
-                    mpNetServer->Broadcast(Update_Packet, PackBoardMap(mBoardMap));
+                    SyncClients();
                     mpNetServer->Broadcast(Log_Packet, new QByteArray(rtnData.second.toLatin1()));
                 }
             }
@@ -255,29 +199,292 @@ void CGame::Play(ECellColors eAggressor, ECellColors eVictim)
         qInfo("%s", pMsg);
         delete[] pMsg;
 
-        // Check if there is only 1 color.
-        if (1 == mvNations.size())
+        // Check if someone won.
+        const ECellColors eWinner = FindWinner(mpBoard, eAggressor);
+        if (Comb_Mixed != eWinner) { AnnounceWinner(eWinner); }
+    }
+}
+
+/*!
+ * \brief CGame::SyncClients
+ *
+ * This method sends the clients every cell that changed since the last sync, diffing the published board against what was last sent. Only tiles written since
+ * then can differ, so a sync costs in proportion to the part of the board that was played on.
+ */
+void CGame::SyncClients()
+{
+    if (nullptr == mpNetServer || nullptr == mpBoard) { return; }
+
+    std::map<u64, ECellColors> mBoardMap;
+    std::shared_ptr<const CCellSnapshot> pSnapshot = mpBoard->GetSnapshot();
+    const u32 c_uNumCells = (nullptr != pSnapshot) ? pSnapshot->GetCount() : 0;
+
+    if (mvOldColors.size() != c_uNumCells)
+    {
+        mvOldColors.assign(c_uNumCells, PALETTE_NONE);
+        muSyncVersion = 0;
+    }
+
+    for (u32 uTile = 0; nullptr != pSnapshot && pSnapshot->GetNumTiles() > uTile; ++uTile)
+    {
+        const SCellTile* pTile = pSnapshot->GetTile(uTile);
+        if (nullptr == pTile || muSyncVersion >= pTile->muVersion) { continue; }
+
+        for (u32 uSlot = 0; CELL_TILE_SZ > uSlot; ++uSlot)
         {
-            std::string sMsg = g_ColorNameMap[mvNations[0]->GetNationColor()].toStdString();
-            sMsg.append(" has won!");
+            const u32 c_uIdx = (uTile << CELL_TILE_SHIFT) | uSlot;
+            if (0 != pTile->muValid[uSlot] && mvOldColors[c_uIdx] != pTile->muColor[uSlot])
+            {
+                mBoardMap.insert(std::pair<u64, ECellColors>(pSnapshot->IndexToCoord(c_uIdx).ToID(), PaletteToColor(pTile->muColor[uSlot])));
+                mvOldColors[c_uIdx] = pTile->muColor[uSlot];
+            }
+        }
+    }
+    muSyncVersion = (nullptr != pSnapshot) ? pSnapshot->GetVersion() : 0;
+
+    if (!mBoardMap.empty()) { mpNetServer->Broadcast(Update_Packet, PackBoardMap(mBoardMap)); }
+}
+
+/*!
+ * \brief CGame::AnnounceWinner
+ *
+ * This method tells everyone who won, draws the final board and ends the game (and auto-play with it).
+ *
+ * \param eWinner - The winning color.
+ */
+void CGame::AnnounceWinner(ECellColors eWinner)
+{
+    std::string sMsg = ColorName(eWinner).toStdString();
+    sMsg.append(" has won!");
+
+    qInfo("%s", sMsg.c_str());
+
+    sMsg.insert(0, "[Info]: ");
+    if (nullptr != mpNetServer)
+    {
+        mpNetServer->Broadcast(Log_Packet, new QByteArray(sMsg.c_str()));
+    }
+
+    StopAutoPlay();
+    Draw();
+    EndGame();
+}
 
-            qInfo("%s", sMsg.c_str());
+/*!
+ * \brief CGame::StartAutoPlay
+ *
+ * This method starts auto-playing the current game. The arguments can come in any order: a number is the moves per second (AUTO_DEFAULT_RATE if not given) and
+ * a name is the move policy (see CMovePolicy::Create, the last one used if not given).
+ *
+ * \param lCmd - The "/auto" command.
+ */
+void CGame::StartAutoPlay(const SCommand& lCmd)
+{
+    if (nullptr != mpNetClient)
+    {
+        qCritical("Auto-play runs on the server, not on a client!");
+        return;
+    }
 
-            sMsg.insert(0, "[Info]: ");
-            if (nullptr != mpNetServer)
+    u32 uRate = AUTO_DEFAULT_RATE;
+    CMovePolicy* pPolicy = nullptr;
+    for (std::vector<std::string>::const_iterator pArgIter = lCmd.mvArgs.begin(); pArgIter != lCmd.mvArgs.end(); ++pArgIter)
+    {
+        bool bIsNumber = false;
+        const u32 c_uArg = QString::fromStdString(*pArgIter).toUInt(&bIsNumber);
+        if (bIsNumber)
+        {
+            uRate = c_uArg;
+        }
+        else
+        {
+            CMovePolicy* pNewPolicy = CMovePolicy::Create(*pArgIter);
+            if (nullptr == pNewPolicy)
             {
-                mpNetServer->Broadcast(Log_Packet, new QByteArray(sMsg.c_str()));
+                qCritical("Unknown auto-play policy \"%s\"! Try \"random\" or \"border\".", pArgIter->c_str());
+                continue;
             }
 
-            Draw();
-            EndGame();
+            if (nullptr != pPolicy) { delete pPolicy; }
+            pPolicy = pNewPolicy;
+        }
+    }
+
+    if (nullptr == mpAutoPlayer) { mpAutoPlayer = new CAutoPlayer(); }
+    mpAutoPlayer->Start(uRate, pPolicy);
+
+    qInfo("Auto-playing at %u moves a second (%s policy)...", mpAutoPlayer->GetRate(), mpAutoPlayer->GetPolicyName());
+}
+
+/*!
+ * \brief CGame::StopAutoPlay
+ *
+ * This method stops auto-play (if it's running).
+ */
+void CGame::StopAutoPlay()
+{
+    if (nullptr != mpAutoPlayer && mpAutoPlayer->IsRunning())
+    {
+        mpAutoPlayer->Stop();
+        qInfo("Auto-play stopped after %llu moves.", mpAutoPlayer->GetNumMoves());
+    }
+}
+
+/*!
+ * \brief CGame::AutoPlay
+ *
+ * This method makes the auto-play moves that are due (see CAutoPlayer::TakeDueMoves). Moves go through the same rules as "Play" but are made quietly (see
+ * ApplyMove): the board is only published, redrawn and sent to the clients once a frame is due, so the output rate stays bounded however fast the moves are made.
+ */
+void CGame::AutoPlay()
+{
+    if (nullptr == mpAutoPlayer || !mpAutoPlayer->IsRunning()) { return; }
+    if (!IsSetup() || !IsPlaying() || nullptr != mpNetClient)
+    {
+        StopAutoPlay();
+        return;
+    }
+
+    const u32 c_uDue = mpAutoPlayer->TakeDueMoves();
+    for (u32 uMove = 0; c_uDue > uMove; ++uMove)
+    {
+        ECellColors eAggressor = Comb_Mixed;
+        ECellColors eVictim = Comb_Mixed;
+        if (!mpAutoPlayer->PickMove(*mpBoard, *mpDice, eAggressor, eVictim))
+        {
+            StopAutoPlay();
+            break;
         }
+
+        u32 uMvAmnt = 0;
+        if (RollToMove(mpDice->Roll(3, muDiceMax), muDiceMax, uMvAmnt)) { ApplyMove(mpBoard->ColorToNation(eAggressor), mpBoard->ColorToNation(eVictim), uMvAmnt); }
+
+        const ECellColors eWinner = FindWinner(mpBoard, eAggressor);
+        if (Comb_Mixed != eWinner)
+        {
+            mpBoard->GetTerritories()->ClearEvents();
+            mpBoard->PublishSnapshot();
+            SyncClients();
+            AnnounceWinner(eWinner);
+            emit SendGUI_Redraw();
+            return;
+        }
+    }
+
+    // Nobody reports on auto-play's territory changes.
+    mpBoard->GetTerritories()->ClearEvents();
+
+    if (mpAutoPlayer->TakeFrame() || !mpAutoPlayer->IsRunning())
+    {
+        mpBoard->PublishSnapshot();
+        SyncClients();
+        ProcessCommand(SCommand(Cmd_Redraw));
     }
 }
 
+/*!
+ * \brief CGame::RollToMove
+ *
+ * This function turns a roll into the number of cells a move takes. The ranges are centered on the middle of the dice range:
+ *  [x - y](25% of range){center of range}  --->  Move 3 spaces
+ *  [x - y](10% of range){center of range}  --->  Move 5 spaces
+ *  [x - y](5% of range){center of range}   --->  Move 7 spaces
+ *  {center of range}                       --->  Overtake (the whole victim nation)
+ * Anything outside the widest range doesn't move at all.
+ *
+ * \param uRoll - The roll.
+ * \param uDiceMax - Maximum roll of the dice.
+ * \param uMvAmnt - Receives the number of cells to take (0 to overtake), see MoveColor.
+ * \return True if the roll moves, false otherwise.
+ */
+bool CGame::RollToMove(u32 uRoll, u32 uDiceMax, u32& uMvAmnt)
+{
+    const u32 uSmallMvRange = static_cast<u32>(uDiceMax * 0.25f);
+    const u32 uMedMvRange = static_cast<u32>(uDiceMax * 0.10f);
+    const u32 uLrgMvRange = static_cast<u32>(uDiceMax * 0.05f);
+    const u32 uMidOfRange = static_cast<u32>(uDiceMax / 2.0f);
+
+    if ((uSmallMvRange + uMidOfRange) < uRoll || (uMidOfRange - uSmallMvRange) > uRoll) { return false; }
+
+    if (uMidOfRange == uRoll)
+    {
+        uMvAmnt = 0; // Overtake! Move HUGE amount!
+    }
+    else if ((uLrgMvRange + uMidOfRange) >= uRoll && (uMidOfRange - uLrgMvRange) <= uRoll)
+    {
+        uMvAmnt = 7;
+    }
+    else if ((uMedMvRange + uMidOfRange) >= uRoll && (uMidOfRange - uMedMvRange) <= uRoll)
+    {
+        uMvAmnt = 5;
+    }
+    else
+    {
+        uMvAmnt = 3;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief CGame::RollInfection
+ *
+ * This method rolls an infection round: how contagious it is (a roll out of the dice maximum) and the seed that picks it's cells.
+ *
+ * \param aDice - Dice to roll.
+ * \param uDiceMax - Maximum roll of the dice.
+ * \param nChance - Receives the chance [0 - 1] of each contested cell being infected.
+ * \param uSeed - Receives the seed of the round.
+ */
+void CGame::RollInfection(CDice& aDice, u32 uDiceMax, float& nChance, u64& uSeed)
+{
+    nChance = (0 < uDiceMax) ? std::min(1.0f, static_cast<float>(aDice.Roll(1, uDiceMax)) / static_cast<float>(uDiceMax)) : 0.0f;
+    uSeed = (static_cast<u64>(aDice.Roll(0, 0)) << (WORD_SZ / 2)) ^ aDice.Roll(0, 0);
+}
+
+/*!
+ * \brief CGame::FindWinner
+ *
+ * This function checks if a move won the game, either by leaving a single color on the board or by the aggressor holding enough of it. Only the aggressor gained
+ * cells, so it's the only one that could have crossed the line (white is unclaimed land and never wins by share).
+ *
+ * \param pBoard - Board the move was made on.
+ * \param eAggressor - Color that moved.
+ * \return The winning color, Comb_Mixed if nobody has won yet.
+ */
+ECellColors CGame::FindWinner(CBoard* pBoard, ECellColors eAggressor)
+{
+    if (nullptr == pBoard) { return Comb_Mixed; }
+
+    ECellColors eLastColor = Comb_Mixed;
+    u32 uNumLive = 0;
+    for (u8 uClr = 0; NUM_CELL_COLORS > uClr && 2 > uNumLive; ++uClr)
+    {
+        if (0 < pBoard->GetColorCount(PaletteToColor(uClr)))
+        {
+            eLastColor = PaletteToColor(uClr);
+            ++uNumLive;
+        }
+    }
+
+    if (1 == uNumLive) { return eLastColor; }
+
+    return (Cell_White != eAggressor && pBoard->ColorDominates(eAggressor, g_cfgVars.mnWinShare)) ? eAggressor : Comb_Mixed;
+}
+
 void CGame::Destroy()
 {
-    // Delete the dice and board.
+    // Delete the auto-player, odds workers, dice and board.
+    if (nullptr != mpAutoPlayer)
+    {
+        delete mpAutoPlayer;
+        mpAutoPlayer = nullptr;
+    }
+    if (nullptr != mpOdds)
+    {
+        delete mpOdds;
+        mpOdds = nullptr;
+    }
     if (nullptr != mpDice) { delete mpDice; }
     if (nullptr != mpBoard)
     {
@@ -329,17 +536,32 @@ bool CGame::LaunchServer(QString lAddr, u16 lPort)
                 if (bSuccess)
                 {
                     connect(mpNetServer, &CServer::NewClientVerified, [&](u32 uClient){
+                        // The new client is sent everything, so bring the others up to date first and they all go on from the same baseline.
+                        SyncClients();
+
                         std::map<u64, ECellColors> mBoardMap;
-                        std::map<u64, CCell*> mCellMap = mpBoard->GetCellMap();
+                        std::shared_ptr<const CCellSnapshot> pSnapshot = mpBoard->GetSnapshot();
+                        if (nullptr == pSnapshot) { return; }
 
-                        for (std::map<u64,CCell*>::iterator pIter = mCellMap.begin(); pIter != mCellMap.end(); ++pIter)
+                        mvOldColors.assign(pSnapshot->GetCount(), PALETTE_NONE);
+                        for (u32 uTile = 0; pSnapshot->GetNumTiles() > uTile; ++uTile)
                         {
-                            std::pair<u64,CCell*> lMappedCell = (*pIter);
-                            mBoardMap.insert(std::pair<u64, ECellColors>(lMappedCell.first, lMappedCell.second->GetColor()));
+                            const SCellTile* pTile = pSnapshot->GetTile(uTile);
+                            if (nullptr == pTile) { continue; }
+
+                            for (u32 uSlot = 0; CELL_TILE_SZ > uSlot; ++uSlot)
+                            {
+                                const u32 c_uIdx = (uTile << CELL_TILE_SHIFT) | uSlot;
+                                if (0 != pTile->muValid[uSlot])
+                                {
+                                    mBoardMap.insert(std::pair<u64, ECellColors>(pSnapshot->IndexToCoord(c_uIdx).ToID(), PaletteToColor(pTile->muColor[uSlot])));
+                                    mvOldColors[c_uIdx] = pTile->muColor[uSlot];
+                                }
+                            }
                         }
 
                         mpNetServer->Transmit(uClient, Update_Packet, PackBoardMap(mBoardMap));
-                        mmOldBoardMap = mBoardMap;
+                        muSyncVersion = pSnapshot->GetVersion();
                     });
 
                     connect(mpNetServer, &CServer::SendCommand, this, &CGame::ProcessCommand);
@@ -393,30 +615,49 @@ std::pair<bool, QString> CGame::MoveColor(ECellColors eAggressor, ECellColors eV
 
         if (nullptr != pAggrNation && nullptr != pVictimNation)
         {
-            if (0 >= uMvAmnt)
-            {
-                uMvAmnt = pVictimNation->GetNationSize();
-            }
-
             u32 uCellTaken = 0;
             QString lRtnStr = "No cells taken!";
             if (nullptr != pAggrNation && nullptr != pVictimNation)
             {
-                uCellTaken = DoFloodFill(pAggrNation, pVictimNation, uMvAmnt);
+                uCellTaken = ApplyMove(pAggrNation, pVictimNation, uMvAmnt);
+                mpBoard->PublishSnapshot();
 
                 if (0 < uCellTaken)
                 {
                     lRtnStr = QString("%1 Took %2 cells from %3!").arg(pAggrNation->GetNationName()).arg(uCellTaken).arg(pVictimNation->GetNationName());
                     if (0 >= pVictimNation->GetNationSize())
                     {
-                        mvNations.erase(std::find(mvNations.begin(), mvNations.end(), pVictimNation));
                         lRtnStr = QString("%1 has conquered %2!").arg(pAggrNation->GetNationName()).arg(pVictimNation->GetNationName());
                     }
                 }
+                else if (mpBoard->NationsBorder(eAggressor, eVictim))
+                {
+                    lRtnStr = QString("%1 failed to infect %2!").arg(pAggrNation->GetNationName()).arg(pVictimNation->GetNationName());
+                }
                 else
                 {
                     lRtnStr = QString("%1 doesn't border %2!").arg(pAggrNation->GetNationName()).arg(pVictimNation->GetNationName());
                 }
+
+                // Report any territories the move cut apart or joined up.
+                CTerritories* pTerritories = mpBoard->GetTerritories();
+                bool bVictimSplit = false;
+                bool bAggrMerged = false;
+                for (const STerritoryEvent& lEvent : pTerritories->GetEvents())
+                {
+                    bVictimSplit |= (Territory_Split == lEvent.meChange && eVictim == lEvent.meColor);
+                    bAggrMerged |= (Territory_Merged == lEvent.meChange && eAggressor == lEvent.meColor);
+                }
+                pTerritories->ClearEvents();
+
+                if (bVictimSplit && NationExists(eVictim))
+                {
+                    lRtnStr += QString(" %1 has been cut into %2 territories!").arg(pVictimNation->GetNationName()).arg(pTerritories->GetTerritoryCount(eVictim));
+                }
+                if (bAggrMerged)
+                {
+                    lRtnStr += QString(" %1 joined up it's territories!").arg(pAggrNation->GetNationName());
+                }
             }
             else if (nullptr == pAggrNation && nullptr != pVictimNation)
             {
@@ -478,19 +719,18 @@ void CGame::PrintNationStats(ECellColors eClr)
         char* pStats = new char[iBuffSz];
         memset(pStats, 0, iBuffSz);
 
-        for (std::vector<CNation*>::iterator pNatIter = mvNations.begin(); pNatIter != mvNations.end(); ++pNatIter)
-        {
-            CNation* pTmpNat = (*pNatIter);
-            if (pTmpNat->GetNationColor() == eClr)
-            {
-                snprintf(pStats, iBuffSz, "Nation Statistics\n"
-                                          "Nation Name: %s\n"
-                                          "Nation Color: %s\n"
-                                          "Cells Owned: %u",
-                         pTmpNat->GetNationName().toStdString().c_str(), g_ColorNameMap[pTmpNat->GetNationColor()].toStdString().c_str(), pTmpNat->GetNationSize());
-                break;
-            }
-        }
+        // The board keeps the cell counts, so the share is read straight off it.
+        CNation* pTmpNat = mpBoard->ColorToNation(eClr);
+        const u32 c_uOwned = mpBoard->GetColorCount(eClr);
+        const u32 c_uTotal = mpBoard->GetNumValidCells();
+        snprintf(pStats, iBuffSz, "Nation Statistics\n"
+                                  "Nation Name: %s\n"
+                                  "Nation Color: %s\n"
+                                  "Cells Owned: %u (%.1f%% of the board, %.1f%% wins)\n"
+                                  "Territories: %u (largest is %u cells)",
+                 (nullptr != pTmpNat) ? pTmpNat->GetNationName().toStdString().c_str() : ColorName(eClr).toStdString().c_str(), ColorName(eClr).toStdString().c_str(),
+                 c_uOwned, (0 < c_uTotal) ? (100.0 * c_uOwned / c_uTotal) : 0.0, 100.0 * g_cfgVars.mnWinShare,
+                 mpBoard->GetTerritories()->GetTerritoryCount(eClr), mpBoard->GetTerritories()->GetLargestTerritory(eClr));
 
         if (nullptr != pStats && 0 < strlen(pStats))
         {
@@ -500,23 +740,13 @@ void CGame::PrintNationStats(ECellColors eClr)
     }
     else
     {
-        qCritical(QString("Nation %1 = DIED!").arg(g_ColorNameMap[eClr]).toStdString().c_str());
+        qCritical(QString("Nation %1 = DIED!").arg(ColorName(eClr)).toStdString().c_str());
     }
 }
 
 bool CGame::NationExists(ECellColors eColor)
 {
-    bool bFoundNation = false;
-    for (std::vector<CNation*>::iterator pNatIter = mvNations.begin(); pNatIter != mvNations.end(); ++pNatIter)
-    {
-        if ((*pNatIter)->GetNationColor() == eColor && 0 < (*pNatIter)->GetNationSize())
-        {
-            bFoundNation = true;
-            break;
-        }
-    }
-
-    return bFoundNation;
+    return (nullptr != mpBoard && 0 < mpBoard->GetColorCount(eColor));
 }
 
 bool CGame::IsPlaying()
@@ -526,7 +756,7 @@ bool CGame::IsPlaying()
 
 bool CGame::IsSetup()
 {
-    return (nullptr != mpDice && nullptr != mpBoard && 0 < mpBoard->GetCellMap().size());
+    return (nullptr != mpDice && nullptr != mpBoard && 0 < mpBoard->GetCellCount());
 }
 
 u32 CGame::GetDiceMax()
@@ -559,79 +789,211 @@ void CGame::SetCanvasCenter(SPoint aPt)
     mCenter = aPt;
 }
 
+/*!
+ * \brief CGame::ApplyMove
+ *
+ * This function makes a move on the board and the nations and nothing else: the victim nation is dropped once it has no cells left, but the board isn't published
+ * and nothing is reported. MoveColor reports on top of it, auto-play publishes once per frame.
+ *
+ * \param aAggrNation - Nation doing the attacking.
+ * \param aVictimNation - Nation being attacked.
+ * \param uMvAmnt - Most cells to take, 0 to overtake the whole victim nation.
+ * \return Number of cells taken.
+ */
+u32 CGame::ApplyMove(CNation* aAggrNation, CNation* aVictimNation, u32 uMvAmnt)
+{
+    if (nullptr == aAggrNation || nullptr == aVictimNation || aAggrNation == aVictimNation) { return 0; }
+
+    if (0 >= uMvAmnt) { uMvAmnt = aVictimNation->GetNationSize(); }
+
+    const u32 c_uCellsTaken = g_cfgVars.mbInfection ? DoInfectionFill(aAggrNation, aVictimNation, uMvAmnt) : DoFloodFill(aAggrNation, aVictimNation, uMvAmnt);
+    if (0 < c_uCellsTaken && 0 >= aVictimNation->GetNationSize())
+    {
+        std::vector<CNation*>::iterator pNatIter = std::find(mvNations.begin(), mvNations.end(), aVictimNation);
+        if (pNatIter != mvNations.end()) { mvNations.erase(pNatIter); }
+    }
+
+    return c_uCellsTaken;
+}
+
+/*!
+ * \brief CGame::DoFloodFill
+ *
+ * This method takes up to "uMvAmnt" victim cells, nearest to the aggressor first (see CBoard::FloodFill), and hands them to the aggressor's nation.
+ *
+ * \param aAggrNation - Nation doing the attacking.
+ * \param aVictimNation - Nation being attacked.
+ * \param uMvAmnt - Most cells to take.
+ * \return Number of cells taken.
+ */
 u32 CGame::DoFloodFill(CNation* aAggrNation, CNation* aVictimNation, u32 uMvAmnt)
 {
     u32 uCellsTaken = 0;
-    u32 uNewCells = 0;
-    if (nullptr != aAggrNation && nullptr != aVictimNation)
+    if (nullptr != aAggrNation && nullptr != aVictimNation && nullptr != mpBoard)
     {
         // Get the nation colors.
         ECellColors eAggressor = aAggrNation->GetNationColor();
         ECellColors eVictim = aVictimNation->GetNationColor();
 
-        do
+        mvTakenCells.clear();
+        uCellsTaken = mpBoard->FloodFill(eAggressor, eVictim, uMvAmnt, &mvTakenCells);
+        for (std::vector<u32>::iterator pCellIter = mvTakenCells.begin(); pCellIter != mvTakenCells.end(); ++pCellIter)
         {
-            uNewCells = 0;
+            // Yoink!
+            aAggrNation->AddIndex(*pCellIter);
+            aVictimNation->RemoveIndex(*pCellIter);
+        }
 
-            // Iterate over the aggressor's cells.
-            std::vector<u64> vAggrCells = aAggrNation->GetCellIDs();
-            for (std::vector<u64>::iterator iAggrCellIter = vAggrCells.begin(); iAggrCellIter != vAggrCells.end(); ++iAggrCellIter)
-            {
-                u64 uCellID = (*iAggrCellIter);
+        qDebug("%s took %u cells from %s.", ColorName(eAggressor).toStdString().c_str(), uCellsTaken, ColorName(eVictim).toStdString().c_str());
+    }
 
-                // Grab the neighbors of the cell.
-                std::vector<CCell*> vNeighbors = mpBoard->GetCellNeighbors(uCellID);
+    return uCellsTaken;
+}
 
-                QString lMsg("Got %1 neighbors");
-                lMsg = lMsg.arg(vNeighbors.size());
-                qDebug(lMsg.toStdString().c_str());
+/*!
+ * \brief CGame::DoInfectionFill
+ *
+ * This method runs a single infection round: every victim cell touching the aggressor turns with the same chance, decided all at once against the board as it
+ * stood before the round (see CBoard::Infect). The dice set how contagious the round is, and seed which cells it picks (see RollInfection).
+ *
+ * \param aAggrNation - Nation doing the infecting.
+ * \param aVictimNation - Nation being infected.
+ * \param uMvAmnt - Most cells to take (picked at random from the round's seed, if the round infects more).
+ * \return Number of cells taken.
+ */
+u32 CGame::DoInfectionFill(CNation* aAggrNation, CNation* aVictimNation, u32 uMvAmnt)
+{
+    u32 uCellsTaken = 0;
 
-                // Iterate over the owned cells and check the neighbors.
-                for (std::vector<CCell*>::iterator iNeighIter = vNeighbors.begin(); iNeighIter != vNeighbors.end(); ++iNeighIter)
-                {
-                    CCell* pCell = (*iNeighIter);
-                    if (nullptr != pCell && pCell->GetColor() == eVictim)
-                    {
-                        // Yoink!
-                        u64 uNewCellID = static_cast<u32>(pCell->GetPosition().mX);
-                        uNewCellID = uNewCellID << 32;
-                        uNewCellID += static_cast<u32>(pCell->GetPosition().mY);
+    if (nullptr != aAggrNation && nullptr != aVictimNation && nullptr != mpBoard && nullptr != mpDice && 0 < muDiceMax)
+    {
+        ECellColors eAggressor = aAggrNation->GetNationColor();
+        ECellColors eVictim = aVictimNation->GetNationColor();
 
-                        QString qMsg("Taking cell %1 from %2 nation...");
-                        qMsg = qMsg.arg(uNewCellID).arg(g_ColorNameMap[eVictim]);
-                        qDebug(qMsg.toStdString().c_str());
+        float nChance = 0.0f;
+        u64 uSeed = 0;
+        RollInfection(*mpDice, muDiceMax, nChance, uSeed);
 
-                        pCell->SetColor(eAggressor);
+        mvTakenCells.clear();
+        uCellsTaken = mpBoard->Infect(eAggressor, eVictim, nChance, uSeed, uMvAmnt, &mvTakenCells);
+        for (std::vector<u32>::iterator pCellIter = mvTakenCells.begin(); pCellIter != mvTakenCells.end(); ++pCellIter)
+        {
+            aAggrNation->AddIndex(*pCellIter);
+            aVictimNation->RemoveIndex(*pCellIter);
+        }
 
-                        aAggrNation->Add(uNewCellID);
-                        aVictimNation->Remove(uNewCellID);
-                        ++uCellsTaken;
-                        uNewCells = 1;
+        qDebug("%s infected %u cells of %s (%.0f%% chance).", ColorName(eAggressor).toStdString().c_str(), uCellsTaken, ColorName(eVictim).toStdString().c_str(),
+               100.0f * nChance);
+    }
 
-                        if (uCellsTaken >= uMvAmnt) { break; }
-                    }
+    return uCellsTaken;
+}
 
-                    if (uCellsTaken >= uMvAmnt) { break; }
-                }
+/*!
+ * \brief CGame::StartOdds
+ *
+ * This method starts working out each nation's chances of winning from where the game is now. The last published board is handed to the odds workers, which play
+ * it out again and again with the game's rules on threads of their own (leaving a core for the game), so the game carries on while they work. Tick reports the
+ * odds once the time is up.
+ *
+ * \param lCmd - The "!odds" command, it's optional argument is the number of seconds to spend.
+ */
+void CGame::StartOdds(const SCommand& lCmd)
+{
+    std::string sError = "";
+    if (!IsSetup() || !IsPlaying())
+    {
+        sError = "There's no game being played to work out the odds of!";
+    }
+    else if (nullptr != mpOdds && mpOdds->IsRunning())
+    {
+        sError = "Already working out the odds, hang on!";
+    }
 
-                if (uCellsTaken >= uMvAmnt) { break; }
-            }
-        } while(uCellsTaken < uMvAmnt && 0 < uNewCells);
+    if (!sError.empty())
+    {
+        qCritical("%s", sError.c_str());
+        if (nullptr != mpNetServer) { sError.insert(0, "[Error]: "); mpNetServer->Transmit(lCmd.muSenderID, Log_Packet, new QByteArray(sError.c_str())); }
+        return;
     }
 
-    return uCellsTaken;
+    float nBudget = g_cfgVars.mnOddsBudget;
+    if (0 < lCmd.mvArgs.size()) { nBudget = QString::fromStdString(lCmd.mvArgs[0]).toFloat(); }
+    if (0.0f >= nBudget) { nBudget = g_cfgVars.mnOddsBudget; }
+    nBudget = std::min(nBudget, ODDS_MAX_BUDGET);
+
+    if (nullptr == mpOdds)
+    {
+        const u32 c_uNumCores = std::thread::hardware_concurrency();
+
+        mpOdds = new CSimulator();
+        mpOdds->SetNumThreads((1 < c_uNumCores) ? c_uNumCores - 1 : 1);
+        mpOdds->SetTemplateDir(QString::fromStdString(g_cfgVars.msRootDir + "/cache"));
+    }
+
+    mpOdds->SetBoardSize(mpBoard->GetBoardSize());
+    mpOdds->SetCellSize(muCellSz);
+    mpOdds->SetCanvasCenter(mCenter);
+    mpOdds->SetDiceMax(muDiceMax);
+    mpOdds->SetSeed(mpDice->Roll(0, 0));
+    mpOdds->SetStartState(mpBoard->GetSnapshot());
+    mpOdds->RunAsync(ODDS_MAX_GAMES, nBudget);
+
+    qInfo("Working out the odds, this takes %.1f seconds...", nBudget);
 }
 
-u32 CGame::DoInfectionFill(CNation* aAggrNation, CNation* aVictimNation, u32 uMvAmnt)
+/*!
+ * \brief CGame::ReportOdds
+ *
+ * This method reports the odds worked out by StartOdds, most likely winner first. Each chance comes with it's 95% confidence interval, which narrows the more
+ * games could be played in the time given.
+ *
+ * \param aResults - Totals of the played out games.
+ */
+void CGame::ReportOdds(const SSimResults& aResults)
 {
-    u32 uCellsTaken = 0;
+    if (0 == aResults.muGames)
+    {
+        qCritical("Unable to work out the odds, no games could be played out!");
+        return;
+    }
 
-    if (nullptr != aAggrNation && nullptr != aVictimNation)
+    std::vector<u8> vClrs;
+    for (u8 uClr = 0; NUM_CELL_COLORS > uClr; ++uClr)
     {
-        // code
+        if (0 < aResults.mvWins[uClr]) { vClrs.push_back(uClr); }
     }
+    std::stable_sort(vClrs.begin(), vClrs.end(), [&aResults](u8 uLeft, u8 uRight) { return aResults.mvWins[uLeft] > aResults.mvWins[uRight]; });
 
-    return uCellsTaken;
+    const size_t ciBuffSz = 128;
+    char aLine[ciBuffSz];
+    snprintf(aLine, ciBuffSz, "Odds from %u played out games:", aResults.muGames);
+    std::string sOdds = aLine;
+
+    for (std::vector<u8>::iterator pClrIter = vClrs.begin(); pClrIter != vClrs.end(); ++pClrIter)
+    {
+        double nLow = 0.0;
+        double nHigh = 0.0;
+        aResults.GetWinInterval((*pClrIter), nLow, nHigh);
+
+        snprintf(aLine, ciBuffSz, "\n%s: %.1f%% (%.1f%% - %.1f%%)", ColorName(PaletteToColor(*pClrIter)).toStdString().c_str(),
+                 100.0 * aResults.mvWins[*pClrIter] / aResults.muGames, 100.0 * nLow, 100.0 * nHigh);
+        sOdds.append(aLine);
+    }
+
+    if (0 < aResults.muUnfinished)
+    {
+        snprintf(aLine, ciBuffSz, "\nNo winner: %.1f%%", 100.0 * aResults.muUnfinished / aResults.muGames);
+        sOdds.append(aLine);
+    }
+
+    qInfo("%s", sOdds.c_str());
+
+    if (nullptr != mpNetServer)
+    {
+        sOdds.insert(0, "[Info]: ");
+        mpNetServer->Broadcast(Log_Packet, new QByteArray(sOdds.c_str()));
+    }
 }
 
 void CGame::ProcessCommand(SCommand lCmd)
@@ -657,6 +1019,7 @@ void CGame::ProcessCommand(SCommand lCmd)
             if (IsSetup())
             {
                 mbGamePlaying = true;
+                StartAutoPlay(lCmd);
             }
             else
             {
@@ -667,6 +1030,7 @@ void CGame::ProcessCommand(SCommand lCmd)
         }
         case Cmd_StopGame:
         {
+            StopAutoPlay();
             if (IsPlaying())
             {
                 mbGamePlaying = false;
@@ -675,6 +1039,12 @@ void CGame::ProcessCommand(SCommand lCmd)
             sCmd = "Stop Game";
             break;
         }
+        case Cmd_PauseGame:
+        {
+            StopAutoPlay();
+            sCmd = "Pause Game";
+            break;
+        }
         case Cmd_Move:
         {
             // Does nothing for now!
@@ -724,9 +1094,11 @@ void CGame::ProcessCommand(SCommand lCmd)
                         qWarning("White still exists, so we're gonna attack them instead.");
                     }
 
-                    if (g_NameToColorMap.end() != g_NameToColorMap.find(lAggr) && g_NameToColorMap.end() != g_NameToColorMap.find(lVictim))
+                    const ECellColors eAggr = ColorFromName(lAggr);
+                    const ECellColors eVictim = ColorFromName(lVictim);
+                    if (Comb_Mixed != eAggr && Comb_Mixed != eVictim)
                     {
-                        Play(g_NameToColorMap[lAggr], g_NameToColorMap[lVictim]);
+                        Play(eAggr, eVictim);
                         if (nullptr != mpNetServer)
                         {
                             std::string sMsg = "[Info]: ";
@@ -739,7 +1111,7 @@ void CGame::ProcessCommand(SCommand lCmd)
                             mpNetServer->Broadcast(Log_Packet, new QByteArray(sMsg.c_str()));
                         }
                     }
-                    else if (g_NameToColorMap.end() == g_NameToColorMap.find(lAggr) && g_NameToColorMap.end() != g_NameToColorMap.find(lVictim))
+                    else if (Comb_Mixed == eAggr && Comb_Mixed != eVictim)
                     {
                         std::string lMsg = "Your nation (";
                         lMsg.append(lAggr);
@@ -748,7 +1120,7 @@ void CGame::ProcessCommand(SCommand lCmd)
 
                         if (nullptr != mpNetServer) { lMsg.insert(0, "[Error]: "); mpNetServer->Transmit(lCmd.muSenderID, Log_Packet, new QByteArray(lMsg.c_str())); }
                     }
-                    else if (g_NameToColorMap.end() != g_NameToColorMap.find(lAggr) && g_NameToColorMap.end() == g_NameToColorMap.find(lVictim))
+                    else if (Comb_Mixed != eAggr && Comb_Mixed == eVictim)
                     {
                         std::string lMsg = "Their nation (";
                         lMsg.append(lVictim);
@@ -785,12 +1157,14 @@ void CGame::ProcessCommand(SCommand lCmd)
             qInfo("Discord Commands:\n"
                   "!move <color1> <color2>  -  Move a color1 to color2.\n"
                   "!new     -  Run a new game.\n"
+                  "!odds [seconds]  -  Work out each nation's chances of winning.\n"
                   "!redraw  -  Redraw the board.\n"
                   "!stats <color>  -  Give a color nation's stats.\n\n"
                   "CLI Commands:\n"
-                  "/auto   -  Auto-Play the current game.\n"
+                  "/auto [moves/sec] [random|border]  -  Auto-Play the current game.\n"
                   "/connect <ip> <port> -  Connect to a server.\n"
                   "/help   -  Show this help.\n"
+                  "/pause  -  Pause auto-play.\n"
                   "/quit   -  Quits the application.\n"
                   "/server -  Setup a LAN server. (Can take a binding address and port)\n"
                   "/stop   -  Stop/End the current game.");
@@ -808,16 +1182,21 @@ void CGame::ProcessCommand(SCommand lCmd)
             if (0 < lCmd.mvArgs.size())
             {
                 // Locate the nation's color.
-                // g_NameToColorMap
                 QString sClr = QString::fromStdString(lCmd.mvArgs[0]);
                 sClr = sClr.toLower(); // Lower-case it.
                 sClr[0] = sClr[0].toLatin1() - ' '; // Capitalize the first letter.
 
-                PrintNationStats(g_NameToColorMap[sClr.toStdString()]);
+                PrintNationStats(ColorFromName(sClr.toStdString()));
             }
             sCmd = "Nation Stats";
             break;
         }
+        case Cmd_Odds:
+        {
+            StartOdds(lCmd);
+            sCmd = "Odds";
+            break;
+        }
         case Cmd_ConnectToServer:
         {
             if (1 <= lCmd.mvArgs.size())
@@ -861,28 +1240,30 @@ void CGame::ProcessCommand(SCommand lCmd)
     emit SendGUI_Command(sCmd.c_str());
 }
 
-void CGame::Net_UpdateBoard(std::map<u64, ECellColors> lClrMap)
+void CGame::Net_UpdateBoard(const std::map<u64, ECellColors>& lClrMap)
 {
     if (IsSetup())
     {
         qInfo("Received color map from server, updating board...");
-        std::map<u64, CCell*> mCellMap = mpBoard->GetCellMap();
-        for (std::map<u64,ECellColors>::iterator pIter = lClrMap.begin(); pIter != lClrMap.end(); ++pIter)
+        for (std::map<u64,ECellColors>::const_iterator pIter = lClrMap.begin(); pIter != lClrMap.end(); ++pIter)
         {
-            std::pair<u64,ECellColors> lMappedCell = (*pIter);
-            if (nullptr != mCellMap[lMappedCell.first])
+            const std::pair<const u64,ECellColors>& lMappedCell = (*pIter);
+            CCell* pCell = mpBoard->GetCell(mpBoard->GetCellIndex(lMappedCell.first));
+            if (nullptr != pCell)
             {
-                CNation* pCurrent = mpBoard->ColorToNation(mCellMap[lMappedCell.first]->GetColor());
+                CNation* pCurrent = mpBoard->ColorToNation(pCell->GetColor());
                 CNation* pNew = mpBoard->ColorToNation(lMappedCell.second);
 
                 if (nullptr != pCurrent && nullptr != pNew && pCurrent != pNew)
                 {
                     pCurrent->Remove(lMappedCell.first);
                     pNew->Add(lMappedCell.first);
-                    mCellMap[lMappedCell.first]->SetColor(lMappedCell.second);
+                    mpBoard->SetCellColor(mpBoard->GetCellIndex(lMappedCell.first), lMappedCell.second);
                 }
             }
         }
+        mpBoard->GetTerritories()->ClearEvents();
+        mpBoard->PublishSnapshot();
         qInfo("Successfully updated board!");
     }
     else
@@ -902,6 +1283,11 @@ void CGame::Tick()
 {
     qApp->processEvents();
 
+    AutoPlay();
+
+    SSimResults lOdds;
+    if (nullptr != mpOdds && mpOdds->PollResults(lOdds)) { ReportOdds(lOdds); }
+
     if (nullptr != mpNetServer)
     {
 //        mpNetServer->Broadcast(Heartbeat_Packet, new QByteArray("~$$HEARTBEAT"));
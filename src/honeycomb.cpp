@@ -1,31 +1,55 @@
 #include "include/honeycomb.h"
 
+/*!
+ * \brief PaletteBrush
+ *
+ * Returns the fill brush of a palette color (see "include/palette.h"). The brushes are built once on first use, so drawing a cell never constructs one. Anything
+ * that isn't a palette index gets the white brush.
+ */
+static const QBrush& PaletteBrush(u8 uIdx)
+{
+    static const std::vector<QBrush> s_vBrushes = []()
+    {
+        std::vector<QBrush> vBrushes;
+        for (u32 uClr = 0; NUM_CELL_COLORS > uClr; ++uClr)
+        {
+            vBrushes.push_back(QBrush(QColor(c_ColorPalette[uClr].uRed, c_ColorPalette[uClr].uGreen, c_ColorPalette[uClr].uBlue)));
+        }
+
+        return vBrushes;
+    }();
+
+    return s_vBrushes[(NUM_CELL_COLORS > uIdx) ? uIdx : ColorToPalette(Cell_White)];
+}
+
 // ================================ Begin CCell Implementation ================================ //
-CCell::CCell() : mbIsValid{false}, mnSize{0.0f}, mPosition{SPoint(0.0f,0.0f)}, meClr{Cell_White}
+CCell::CCell() : mpStore{nullptr}, muIdx{INVALID_CELL_IDX}
 {
     // Intentionally left blank.
 }
 
-CCell::CCell(const CCell& aCls) : mbIsValid{aCls.mbIsValid}, mnSize{aCls.mnSize}, mPosition{aCls.mPosition}, meClr{aCls.meClr}
+CCell::CCell(CCellStore* pStore, u32 uCellIdx) : mpStore{pStore}, muIdx{uCellIdx}
+{
+    // Intentionally left blank.
+}
+
+CCell::CCell(const CCell& aCls) : mpStore{aCls.mpStore}, muIdx{aCls.muIdx}
 {
     // Intentionally left blank.
 }
 
 CCell::~CCell()
 {
-    mnSize = 0.0f;
-    mPosition = SPoint(0.0f,0.0f);
-    meClr = Cell_White;
+    mpStore = nullptr;
+    muIdx = INVALID_CELL_IDX;
 }
 
 CCell& CCell::operator =(const CCell& aCls)
 {
     if (this != &aCls)
     {
-        mbIsValid = aCls.mbIsValid;
-        mnSize = aCls.mnSize;
-        mPosition = aCls.mPosition;
-        meClr = aCls.meClr;
+        mpStore = aCls.mpStore;
+        muIdx = aCls.muIdx;
     }
 
     return *this;
@@ -36,81 +60,34 @@ bool CCell::Draw(QPainter *pPainter)
     bool bSuccess = false;
     if (nullptr != pPainter)
     {
-        if (mbIsValid)
+        if (IsValid())
         {
-            /*
-             * These values are used in calculations. They're approximates, so accuracy isn't going to happen.
-             * These are based off of "docs/hexagon_dissection.png".
-             * These Are defined as
-                    * "long-leg" : "short-leg" (1:2)
-                    * "long-leg" : "short-start" (1:4)
-                    * "half-width" = 0.86 : "short-leg" (0.86:1)
-             * Static_cast is more than likely unecessary, we're just doing it to ensure we have floats.
-             */
-            // Instantiate a new set of verticies.
-            QPointF pPts[NUM_HEX_VERTS];
-            memset(pPts, 0, sizeof(SPoint) * NUM_HEX_VERTS);
-
-            const float c_nCircumRadius = mnSize / 2.0f;
-            const float c_nDegreePerAngle = 180.0f / 3.0f; // Should be 60.0f
-
-            float nX = mPosition.x();
-            float nY = mPosition.y() - c_nCircumRadius;
-            float nTheta = static_cast<float>(MAX_DEGREE - c_nDegreePerAngle); // We start with a negative degree.
-
-            QRectF qDebugRect;
+            const float c_nSize = GetSize();
+            const SPoint lPos = GetCenter();
 
-            // Begin calculating the points (counter-clockwise, starting at top).
+            // Scale the unit hexagon (see "include/hexgeometry.h") out to the cell.
             //!\NOTE: Our hexagons have the long-leg vertical, meaning they're pointed at the top. (height > width)
+            const float c_nCircumRadius = c_nSize / 2.0f;
+
+            QPointF pPts[NUM_HEX_VERTS];
             for (size_t iIdx = 0; NUM_HEX_VERTS > iIdx; ++iIdx)
             {
-                // Set the vertex position.
-                pPts[iIdx].setX(nX);
-                pPts[iIdx].setY(nY);
-
-                // Calculate the next position.
-                float nThetaRad = static_cast<float>(nTheta * (M_PI / 180.0f));
-                float nXDelta = c_nCircumRadius * sin(nThetaRad);
-                float nYDelta = c_nCircumRadius * cos(nThetaRad);
-
-                // Subtract both.
-                nX += nXDelta;
-                nY += nYDelta;
-
-                nTheta += c_nDegreePerAngle;
-                if (nTheta >= MAX_DEGREE)
-                {
-                    nTheta -= MAX_DEGREE;
-                }
-
-                // Setup the debugging rectangle.
-                if (iIdx == 0) { qDebugRect.setTop(nY); }
-                else if (iIdx == 1) { qDebugRect.setRight(nX); }
-                else if (iIdx == 3) { qDebugRect.setBottom(nY); }
-                else if (iIdx == 4) { qDebugRect.setLeft(nX); }
+                pPts[iIdx].setX(lPos.mX + c_nHexVertX[iIdx] * c_nCircumRadius);
+                pPts[iIdx].setY(lPos.mY + c_nHexVertY[iIdx] * c_nCircumRadius);
             }
 
+            // Setup the debugging rectangle.
+            QRectF qDebugRect;
+            qDebugRect.setTop(pPts[1].y());
+            qDebugRect.setRight(pPts[2].x());
+            qDebugRect.setBottom(pPts[4].y());
+            qDebugRect.setLeft(pPts[5].x());
+
             // Done, now we want to set the painter to draw the hexagon correctly.
             pPainter->setPen(QPen(QBrush(Qt::black), 2.0));
 
             // Set the fill color.
-            switch (meClr)
-            {
-                case Cell_White: pPainter->setBrush(QBrush(QColor(255, 255, 255))); break;
-                case Cell_Red: pPainter->setBrush(QBrush(QColor(255, 0, 0))); break;
-                case Cell_Orange: pPainter->setBrush(QBrush(QColor(255, 175, 0))); break;
-                case Cell_Yellow: pPainter->setBrush(QBrush(QColor(255, 255, 0))); break;
-                case Cell_Lime: pPainter->setBrush(QBrush(QColor(175, 255, 0))); break;
-                case Cell_Green: pPainter->setBrush(QBrush(QColor(0, 175, 0))); break;
-                case Cell_Cyan: pPainter->setBrush(QBrush(QColor(0, 255, 255))); break;
-                case Cell_Blue: pPainter->setBrush(QBrush(QColor(0, 0, 255))); break;
-                case Cell_Purple: pPainter->setBrush(QBrush(QColor(125, 0, 255))); break;
-                case Cell_Magenta: pPainter->setBrush(QBrush(QColor(255, 0, 255))); break;
-                case Cell_Pink: pPainter->setBrush(QBrush(QColor(255, 0, 125))); break;
-                case Cell_Brown: pPainter->setBrush(QBrush(QColor(125, 50, 0))); break;
-                case Cell_Gray: pPainter->setBrush(QBrush(QColor(125, 125, 125))); break;
-                default: pPainter->setBrush(QBrush(QColor(255, 255, 255))); break;
-            }
+            pPainter->setBrush(PaletteBrush(mpStore->GetColorIdx(muIdx)));
 
             // Draw the points!
             pPainter->drawPolygon(pPts, NUM_HEX_VERTS);
@@ -122,7 +99,7 @@ bool CCell::Draw(QPainter *pPainter)
                 pPainter->setPen(QPen(Qt::black, 2.0));
 
                 // Draw the position in the center of the cell.
-                pPainter->drawText(qDebugRect, Qt::AlignCenter, QString("X: %1\nY: %2").arg(mPosition.mX).arg(mPosition.mY));
+                pPainter->drawText(qDebugRect, Qt::AlignCenter, QString("X: %1\nY: %2").arg(lPos.mX).arg(lPos.mY));
             }
 
             // Set success!
@@ -143,72 +120,85 @@ bool CCell::Draw(QPainter *pPainter)
 
 bool CCell::PointInHex(SPoint &aPt)
 {
-    const float c_nInscribedRadius = (static_cast<float>(sqrt(3)) / 2.0) * (mnSize / 2.0f);
-    float nOppSqr = pow( abs(aPt.x() - mPosition.x()), 2.0);
-    float nAdjSqr = pow( abs(aPt.y() - mPosition.y()), 2.0);
-    float nDelta = sqrt(nOppSqr + nAdjSqr);
-
-    return (nDelta < c_nInscribedRadius) ? true : false;
+    const SPoint lPos = GetCenter();
+    return HexContains(aPt.x() - lPos.mX, aPt.y() - lPos.mY, GetSize() / 2.0f);
 }
 
 float CCell::GetSize()
 {
-    return mnSize;
+    return (nullptr != mpStore) ? mpStore->GetCellSize() : 0.0f;
 }
 
-const SPoint& CCell::GetCenter()
+SPoint CCell::GetCenter()
 {
-    return mPosition;
+    return (nullptr != mpStore) ? mpStore->GetCenter(muIdx) : SPoint();
 }
 
-const SPoint& CCell::GetPosition()
+SPoint CCell::GetPosition()
 {
-    return mPosition;
+    return GetCenter();
+}
+
+SHexCoord CCell::GetCoord()
+{
+    return (nullptr != mpStore) ? mpStore->IndexToCoord(muIdx) : SHexCoord();
 }
 
 ECellColors CCell::GetColor()
 {
-    return meClr;
+    return (nullptr != mpStore) ? mpStore->GetColor(muIdx) : Cell_White;
+}
+
+u32 CCell::GetIndex()
+{
+    return muIdx;
 }
 
 bool CCell::IsValid()
 {
-    return mbIsValid;
+    return (nullptr != mpStore && 0.0f < mpStore->GetCellSize() && mpStore->IsValid(muIdx));
 }
 
+/*!
+ * \brief CCell::SetSize
+ *
+ * Sets the size of the cell. Every cell of a board shares one size, so this sets it for the whole store the cell lives in.
+ *
+ * \param anSize - New size in pixels.
+ */
 void CCell::SetSize(const float anSize)
 {
-    mnSize = anSize;
-    if (0.0f < mnSize) { mbIsValid = true; }
+    if (nullptr != mpStore) { mpStore->SetCellSize(anSize); }
 }
 
 void CCell::SetCenter(const SPoint &aqCenter)
 {
-    mPosition = aqCenter;
-    if (0.0f < mnSize) { mbIsValid = true; }
+    if (nullptr != mpStore) { mpStore->SetCenter(muIdx, aqCenter); }
 }
 
 void CCell::SetPosition(const SPoint &aqPosition)
 {
-    mPosition = aqPosition;
-    if (0.0f < mnSize) { mbIsValid = true; }
+    SetCenter(aqPosition);
 }
 
 void CCell::SetColor(ECellColors aeClr)
 {
-    meClr = aeClr;
+    if (nullptr != mpStore) { mpStore->SetColor(muIdx, aeClr); }
 }
 // ================================ End CCell Implementation ================================ //
 
 // ================================ Begin CHoneycomb Implementation ================================ //
-CHoneyComb::CHoneyComb() : mnCellSize{0.0f}, mPosition{SPoint(0.0f, 0.0f)}, meCombColor{Cell_White}
+CHoneyComb::CHoneyComb() : mnCellSize{0.0f}, mPosition{SPoint(0.0f, 0.0f)}, mCoord{SHexCoord(0, 0)}, meCombColor{Cell_White}, mpCells{}, muNumCells{0}, mauColorCounts{},
+    muNumValidCells{0}
 {
     // Intentionally left blank.
 }
 
-CHoneyComb::CHoneyComb(const CHoneyComb& aCls) : mnCellSize{aCls.mnCellSize}, mPosition{aCls.mPosition}, meCombColor{aCls.meCombColor}, mpCells{aCls.mpCells}
+CHoneyComb::CHoneyComb(const CHoneyComb& aCls) : mnCellSize{aCls.mnCellSize}, mPosition{aCls.mPosition}, mCoord{aCls.mCoord}, meCombColor{aCls.meCombColor}, mpCells{},
+    muNumCells{aCls.muNumCells}, mauColorCounts{}, muNumValidCells{aCls.muNumValidCells}
 {
-    // Intentionally left blank.
+    std::copy(aCls.mpCells, aCls.mpCells + c_iMaxCells, mpCells);
+    std::copy(aCls.mauColorCounts, aCls.mauColorCounts + NUM_CELL_COLORS, mauColorCounts);
 }
 
 CHoneyComb::~CHoneyComb()
@@ -223,8 +213,12 @@ CHoneyComb& CHoneyComb::operator =(const CHoneyComb& aCls)
     {
         mnCellSize = aCls.mnCellSize;
         mPosition = aCls.mPosition;
+        mCoord = aCls.mCoord;
         meCombColor = aCls.meCombColor;
-        mpCells = aCls.mpCells;
+        std::copy(aCls.mpCells, aCls.mpCells + c_iMaxCells, mpCells);
+        muNumCells = aCls.muNumCells;
+        std::copy(aCls.mauColorCounts, aCls.mauColorCounts + NUM_CELL_COLORS, mauColorCounts);
+        muNumValidCells = aCls.muNumValidCells;
     }
 
     return *this;
@@ -232,17 +226,17 @@ CHoneyComb& CHoneyComb::operator =(const CHoneyComb& aCls)
 
 CCell *CHoneyComb::operator [](size_t iIdx)
 {
-    if (c_iMaxCells > iIdx)
+    if (muNumCells > iIdx)
     {
         return mpCells[iIdx];
     }
 
-    return mpCells[c_iMaxCells-1];
+    return (0 < muNumCells) ? mpCells[muNumCells-1] : nullptr;
 }
 
-std::vector<CCell*> CHoneyComb::operator *()
+CSpan<CCell* const> CHoneyComb::operator *()
 {
-    return mpCells;
+    return GetCells();
 }
 
 bool CHoneyComb::Draw(QPainter *pPainter)
@@ -250,7 +244,7 @@ bool CHoneyComb::Draw(QPainter *pPainter)
     bool bSuccess = true;
     if (nullptr != pPainter && IsInitialized())
     {
-        for (std::vector<CCell*>::iterator pIter = mpCells.begin(); pIter != mpCells.end() && bSuccess; ++pIter)
+        for (CCell** pIter = mpCells; pIter != (mpCells + muNumCells) && bSuccess; ++pIter)
         {
             CCell *pTmpCell = (*pIter);
             if (pTmpCell->IsValid())
@@ -265,67 +259,66 @@ bool CHoneyComb::Draw(QPainter *pPainter)
 
 bool CHoneyComb::PointInComb(SPoint &aPt)
 {
-    bool bSuccess = false;
+    return (muNumCells > CellSlotAtPoint(aPt));
+}
 
-    if (IsInitialized())
-    {
-        for (std::vector<CCell*>::iterator pIter = mpCells.begin(); pIter != mpCells.end() && !bSuccess; ++pIter)
-        {
-            CCell *pTmpCell = (*pIter);
-            if (pTmpCell->IsValid())
-            {
-                bSuccess = pTmpCell->PointInHex(aPt);
-            }
-        }
-    }
+bool CHoneyComb::CombIsAllColor(ECellColors aeClr)
+{
+    return (!IsInitialized() || GetColorCount(aeClr) == muNumValidCells);
+}
 
-    return bSuccess;
+bool CHoneyComb::CombContainsColor(ECellColors aeClr)
+{
+    return (IsInitialized() && 0 < GetColorCount(aeClr));
 }
 
-bool CHoneyComb::CombIsAllColor(ECellColors aeClr)
+bool CHoneyComb::IsUniform()
 {
-    bool bSuccess = true;
+    return (Comb_Mixed != meCombColor);
+}
 
-    if (IsInitialized())
-    {
-        for (std::vector<CCell*>::iterator pIter = mpCells.begin(); pIter != mpCells.end() && bSuccess; ++pIter)
-        {
-            CCell *pTmpCell = (*pIter);
-            if (pTmpCell->IsValid())
-            {
-                if (pTmpCell->GetColor() != aeClr)
-                {
-                    bSuccess = false;
-                    break;
-                }
-            }
-        }
-    }
+/*!
+ * \brief CHoneyComb::CellColorChanged
+ *
+ * Moves one cell between the color counts. Call this whenever one of the comb's cells is recolored.
+ *
+ * \param eOldClr - Color the cell had.
+ * \param eNewClr - Color the cell has now.
+ */
+void CHoneyComb::CellColorChanged(ECellColors eOldClr, ECellColors eNewClr)
+{
+    const u8 c_uOld = ColorToPalette(eOldClr);
+    const u8 c_uNew = ColorToPalette(eNewClr);
 
-    return bSuccess;
+    if (NUM_CELL_COLORS > c_uOld && 0 < mauColorCounts[c_uOld]) { --mauColorCounts[c_uOld]; }
+    if (NUM_CELL_COLORS > c_uNew) { ++mauColorCounts[c_uNew]; }
+
+    UpdateCombColor();
 }
 
-bool CHoneyComb::CombContainsColor(ECellColors aeClr)
+/*!
+ * \brief CHoneyComb::RecountColors
+ *
+ * Rebuilds the color counts from the cells themselves. This is done when the comb is handed it's cells, and is needed again only if cells were recolored without
+ * going through "CellColorChanged".
+ */
+void CHoneyComb::RecountColors()
 {
-    bool bSuccess = false;
+    std::fill(mauColorCounts, mauColorCounts + NUM_CELL_COLORS, 0);
+    muNumValidCells = 0;
 
-    if (IsInitialized())
+    for (CCell** pIter = mpCells; pIter != (mpCells + muNumCells); ++pIter)
     {
-        for (std::vector<CCell*>::iterator pIter = mpCells.begin(); pIter != mpCells.end() && !bSuccess; ++pIter)
+        CCell *pTmpCell = (*pIter);
+        if (nullptr != pTmpCell && pTmpCell->IsValid())
         {
-            CCell *pTmpCell = (*pIter);
-            if (pTmpCell->IsValid())
-            {
-                if (pTmpCell->GetColor() == aeClr)
-                {
-                    bSuccess = true;
-                    break;
-                }
-            }
+            const u8 c_uClr = ColorToPalette(pTmpCell->GetColor());
+            if (NUM_CELL_COLORS > c_uClr) { ++mauColorCounts[c_uClr]; }
+            ++muNumValidCells;
         }
     }
 
-    return bSuccess;
+    UpdateCombColor();
 }
 
 bool CHoneyComb::IsInitialized()
@@ -353,26 +346,38 @@ const SPoint& CHoneyComb::GetPosition()
     return mPosition;
 }
 
-std::vector<CCell*> CHoneyComb::GetCells()
+const SHexCoord& CHoneyComb::GetCoord()
+{
+    return mCoord;
+}
+
+/*!
+ * \brief CHoneyComb::GetCells
+ *
+ * Returns a view of the comb's cells (center first). Nothing is copied, the view looks straight at the comb.
+ *
+ * \return View of the cells.
+ */
+CSpan<CCell* const> CHoneyComb::GetCells()
 {
-    return mpCells;
+    return CSpan<CCell* const>(mpCells, muNumCells);
 }
 
 CCell* CHoneyComb::GetCellAt(u32 iCellIdx)
 {
-    return (mpCells.size() > iCellIdx) ? mpCells[iCellIdx] : mpCells[mpCells.size()-1];
+    return (*this)[iCellIdx];
 }
 
 CCell* CHoneyComb::GetCellNotColor(ECellColors aeClr)
 {
     CCell* rCell = nullptr;
 
-    if (IsInitialized())
+    if (IsInitialized() && GetColorCount(aeClr) != muNumValidCells)
     {
-        for (std::vector<CCell*>::iterator pIter = mpCells.begin(); pIter != mpCells.end(); ++pIter)
+        for (CCell** pIter = mpCells; pIter != (mpCells + muNumCells); ++pIter)
         {
             CCell *pTmpCell = (*pIter);
-            if (pTmpCell->GetColor() != aeClr)
+            if (nullptr != pTmpCell && pTmpCell->IsValid() && pTmpCell->GetColor() != aeClr)
             {
                 rCell = pTmpCell;
                 break;
@@ -387,12 +392,12 @@ CCell* CHoneyComb::GetCellIsColor(ECellColors aeClr)
 {
     CCell* rCell = nullptr;
 
-    if (IsInitialized())
+    if (IsInitialized() && 0 < GetColorCount(aeClr))
     {
-        for (std::vector<CCell*>::iterator pIter = mpCells.begin(); pIter != mpCells.end(); ++pIter)
+        for (CCell** pIter = mpCells; pIter != (mpCells + muNumCells); ++pIter)
         {
             CCell *pTmpCell = (*pIter);
-            if (pTmpCell->GetColor() == aeClr)
+            if (nullptr != pTmpCell && pTmpCell->IsValid() && pTmpCell->GetColor() == aeClr)
             {
                 rCell = pTmpCell;
                 break;
@@ -405,13 +410,16 @@ CCell* CHoneyComb::GetCellIsColor(ECellColors aeClr)
 
 size_t CHoneyComb::GetCellIdxNotColor(ECellColors eIsNotColor)
 {
+    // Nothing to look for if every (valid) cell is that color.
+    if (GetColorCount(eIsNotColor) == muNumValidCells) { return (IsInitialized() ? muNumCells : 0); }
+
     size_t iCellIdx = 0;
     if (IsInitialized())
     {
-        for (std::vector<CCell*>::iterator pIter = mpCells.begin(); pIter != mpCells.end(); ++pIter, ++iCellIdx)
+        for (CCell** pIter = mpCells; pIter != (mpCells + muNumCells); ++pIter, ++iCellIdx)
         {
             CCell* pTmp = (*pIter);
-            if (pTmp->GetColor() != eIsNotColor)
+            if (nullptr != pTmp && pTmp->IsValid() && pTmp->GetColor() != eIsNotColor)
             {
                 break;
             }
@@ -423,13 +431,16 @@ size_t CHoneyComb::GetCellIdxNotColor(ECellColors eIsNotColor)
 
 size_t CHoneyComb::GetCellIdxColor(ECellColors eIsColor)
 {
+    // Nothing to look for if no cell is that color.
+    if (0 == GetColorCount(eIsColor)) { return (IsInitialized() ? muNumCells : 0); }
+
     size_t iCellIdx = 0;
     if (IsInitialized())
     {
-        for (std::vector<CCell*>::iterator pIter = mpCells.begin(); pIter != mpCells.end(); ++pIter, ++iCellIdx)
+        for (CCell** pIter = mpCells; pIter != (mpCells + muNumCells); ++pIter, ++iCellIdx)
         {
             CCell* pTmp = (*pIter);
-            if (pTmp->GetColor() == eIsColor)
+            if (nullptr != pTmp && pTmp->IsValid() && pTmp->GetColor() == eIsColor)
             {
                 break;
             }
@@ -444,46 +455,21 @@ ECellColors CHoneyComb::GetCombColor()
     return meCombColor;
 }
 
-CCell* CHoneyComb::GetCellAtPoint(SPoint &aPt)
+u32 CHoneyComb::GetColorCount(ECellColors aeClr)
 {
-    CCell *pRtnCell = nullptr;
-
-    if (IsInitialized())
-    {
-        for (std::vector<CCell*>::iterator pIter = mpCells.begin(); pIter != mpCells.end(); ++pIter)
-        {
-            CCell* pTmpCell = (*pIter);
-            if (pTmpCell->IsValid() && pTmpCell->PointInHex(aPt))
-            {
-                pRtnCell = pTmpCell;
-            }
-        }
-    }
+    const u8 c_uClr = ColorToPalette(aeClr);
+    return (NUM_CELL_COLORS > c_uClr) ? mauColorCounts[c_uClr] : 0;
+}
 
-    return pRtnCell;
+CCell* CHoneyComb::GetCellAtPoint(SPoint &aPt)
+{
+    const u32 c_uSlot = CellSlotAtPoint(aPt);
+    return (muNumCells > c_uSlot) ? mpCells[c_uSlot] : nullptr;
 }
 
 u32 CHoneyComb::GetCellIdxAtPoint(SPoint &aPt)
 {
-    u32 uRtnIdx = 0;
-
-    if (IsInitialized())
-    {
-        for (std::vector<CCell*>::iterator pIter = mpCells.begin(); pIter != mpCells.end(); ++pIter)
-        {
-            CCell* pTmpCell = (*pIter);
-            if (pTmpCell->IsValid() && pTmpCell->PointInHex(aPt))
-            {
-                break;
-            }
-            else
-            {
-                ++uRtnIdx;
-            }
-        }
-    }
-
-    return uRtnIdx;
+    return IsInitialized() ? CellSlotAtPoint(aPt) : 0;
 }
 
 void CHoneyComb::SetCellSize(const float anSize)
@@ -500,6 +486,36 @@ void CHoneyComb::SetPosition(const SPoint& aqPosition)
     if (IsInitialized()) { RecalcPositions(); }
 }
 
+/*!
+ * \brief CHoneyComb::SetCoord
+ *
+ * Sets the lattice coordinate of the center cell. The outer cells sit at the center's neighbors, in the same order they're positioned in.
+ *
+ * \param aCoord - Axial coordinate of the center cell.
+ */
+void CHoneyComb::SetCoord(const SHexCoord& aCoord)
+{
+    mCoord = aCoord;
+}
+
+/*!
+ * \brief CHoneyComb::SetCells
+ *
+ * Hands the honeycomb the cells it's made of (center first, then the outer cells in neighbor order). The cells are views owned by the board, the honeycomb only
+ * positions them.
+ *
+ * \param vCells - The cells of the honeycomb.
+ * \param bReposition - Position the cells around the comb, false if they're already placed (e.g. loaded from a board template).
+ */
+void CHoneyComb::SetCells(const std::vector<CCell*>& vCells, bool bReposition)
+{
+    muNumCells = static_cast<u32>(std::min<size_t>(vCells.size(), c_iMaxCells));
+    std::copy(vCells.begin(), vCells.begin() + muNumCells, mpCells);
+
+    if (bReposition && IsInitialized()) { RecalcPositions(); }
+    RecountColors();
+}
+
 void CHoneyComb::SetCombColor(ECellColors aeClr)
 {
     if (IsInitialized())
@@ -512,7 +528,7 @@ void CHoneyComb::SetAllCellColor(ECellColors aeClr)
 {
     if (IsInitialized())
     {
-        for (std::vector<CCell*>::iterator pIter = mpCells.begin(); pIter != mpCells.end(); ++pIter)
+        for (CCell** pIter = mpCells; pIter != (mpCells + muNumCells); ++pIter)
         {
             CCell *pTmpCell = (*pIter);
             if (pTmpCell->IsValid())
@@ -520,7 +536,8 @@ void CHoneyComb::SetAllCellColor(ECellColors aeClr)
                 pTmpCell->SetColor(aeClr);
             }
         }
-        meCombColor = aeClr;
+
+        RecountColors();
     }
 }
 
@@ -531,58 +548,27 @@ void CHoneyComb::RecalcPositions()
         /*
          * Begin recalculation.
          *
-         * These positions are actually calculated using the same hexagon calculations for the cells. The only difference being that the
-         * hexagon here is rotated 90-degrees clockwise (so instead of moving up first, we move right).
-         *
-         * This means that this method makes use of the consts in friend class CCell.
+         * The cells sit on the board's axial lattice, so each neighbor is a fixed multiple of the cell circum-radius away from the center cell. The neighbor
+         * offsets follow the direction order of SHexCoord (left, then clockwise on screen), which is the order the cells are handed to the comb.
          */
 
-        // FIRST: Clear the cell vector to prevent weirdness.
-        while (mpCells.begin() != mpCells.end())
-        {
-            mpCells.pop_back();
-        }
-
-        // Simple variable to help us track half-height of the polygon.
-        const float c_nCombSize = GetCombSize();
-        const float c_nCircumRadius = c_nCombSize / 2.0f;
-        const float c_nDegreePerAngle = 180.0f / 3.0f; // Should be 60.0f
-
-        float nX = mPosition.x();
-        float nY = mPosition.y();
-        float nTheta = static_cast<float>(MAX_DEGREE - c_nDegreePerAngle); // We start with a negative degree.
+        const float c_nCellRadius = mnCellSize / 2.0f;
+        const float nX = mPosition.x();
+        const float nY = mPosition.y();
 
         // Explicitly set the center comb.
-        CCell *pTmpCell = new CCell();
-        pTmpCell->SetSize(mnCellSize);
-        pTmpCell->SetPosition(SPoint(nX, nY));
-        mpCells.push_back(pTmpCell);
-
-        nX -= c_nCircumRadius;
+        if (0 < muNumCells && nullptr != mpCells[0])
+        {
+            mpCells[0]->SetSize(mnCellSize);
+            mpCells[0]->SetPosition(SPoint(nX, nY));
+        }
 
-        // Begin calculating the points (counter-clockwise, starting at top).
-        //!\NOTE: Our hexagons have the long-leg vertical, meaning they're pointed at the top. (height > width)
-        for (size_t iIdx = 1; (NUM_HEX_VERTS+1) > iIdx; ++iIdx)
+        for (size_t iIdx = 1; muNumCells > iIdx; ++iIdx)
         {
-            // Set the cell position.
-            CCell *pTmpCell = new CCell();
-            pTmpCell->SetSize(mnCellSize);
-            pTmpCell->SetPosition(SPoint(nX, nY));
-            mpCells.push_back(pTmpCell);
-
-            // Calculate the next position.
-            float nThetaRad = static_cast<float>(nTheta * (M_PI / 180.0f));
-            float nXDelta = c_nCircumRadius * cos(nThetaRad);
-            float nYDelta = c_nCircumRadius * sin(nThetaRad);
-
-            // Subtract both.
-            nX += nXDelta;
-            nY += nYDelta;
-
-            nTheta += c_nDegreePerAngle;
-            if (nTheta >= MAX_DEGREE)
+            if (nullptr != mpCells[iIdx])
             {
-                nTheta -= MAX_DEGREE;
+                mpCells[iIdx]->SetSize(mnCellSize);
+                mpCells[iIdx]->SetPosition(SPoint(nX + c_nHexDirX[iIdx-1] * c_nCellRadius, nY + c_nHexDirY[iIdx-1] * c_nCellRadius));
             }
         }
 
@@ -590,4 +576,44 @@ void CHoneyComb::RecalcPositions()
     }
 }
 
+/*!
+ * \brief CHoneyComb::CellSlotAtPoint
+ *
+ * Finds which of the comb's cells a point falls in. The point is rounded to the lattice around the center cell (see SHexCoord::FromPixel), which is either the
+ * center itself or one of it's neighbors, so no cell is tested individually.
+ *
+ * \param aPt - Position in pixels.
+ * \return Index of the cell in the comb (0 is the center), or the number of cells if the point isn't on a valid cell of this comb.
+ */
+u32 CHoneyComb::CellSlotAtPoint(const SPoint& aPt)
+{
+    if (!IsInitialized()) { return muNumCells; }
+
+    const float c_nCellRadius = mnCellSize / 2.0f;
+    const SHexCoord lLocal = SHexCoord::FromPixel((aPt.mX - mPosition.mX) / c_nCellRadius, (aPt.mY - mPosition.mY) / c_nCellRadius);
+    const u32 c_uSlot = (SHexCoord() == lLocal) ? 0 : SHexCoord().DirectionTo(lLocal) + 1;
+
+    return (muNumCells > c_uSlot && nullptr != mpCells[c_uSlot] && mpCells[c_uSlot]->IsValid()) ? c_uSlot : muNumCells;
+}
+
+/*!
+ * \brief CHoneyComb::UpdateCombColor
+ *
+ * Sets the comb color from the color counts: the shared color if every valid cell has it, Comb_Mixed otherwise. A comb without valid cells keeps it's color.
+ */
+void CHoneyComb::UpdateCombColor()
+{
+    if (0 == muNumValidCells) { return; }
+
+    meCombColor = Comb_Mixed;
+    for (u8 uClr = 0; NUM_CELL_COLORS > uClr; ++uClr)
+    {
+        if (mauColorCounts[uClr] == muNumValidCells)
+        {
+            meCombColor = PaletteToColor(uClr);
+            break;
+        }
+    }
+}
+
 // ================================ End CHoneycomb Implementation ================================ //
@@ -1,6 +1,6 @@
 #include "include/mainwindow.h"
+#include "include/simulator.h"
 
-std::map<ECellColors, QString> g_ColorNameMap;
 CfgVars g_cfgVars;
 
 CGame *mpGame;
@@ -10,23 +10,6 @@ CMainWindow *pMainWnd;
 static std::filebuf l_fileBuff;
 static std::ostream l_logStream(&l_fileBuff);
 
-void SetupColorNames()
-{
-    g_ColorNameMap[Cell_White] = "White";
-    g_ColorNameMap[Cell_Red] = "Red";
-    g_ColorNameMap[Cell_Orange] = "Orange";
-    g_ColorNameMap[Cell_Yellow] = "Yellow";
-    g_ColorNameMap[Cell_Lime] = "Lime";
-    g_ColorNameMap[Cell_Green] = "Green";
-    g_ColorNameMap[Cell_Cyan] = "Cyan";
-    g_ColorNameMap[Cell_Blue] = "Blue";
-    g_ColorNameMap[Cell_Purple] = "Purple";
-    g_ColorNameMap[Cell_Magenta] = "Magenta";
-    g_ColorNameMap[Cell_Pink] = "Pink";
-    g_ColorNameMap[Cell_Brown] = "Brown";
-    g_ColorNameMap[Cell_Gray] = "Gray";
-}
-
 // -------------------------------- BEGIN LOGGING -------------------------------- //
 void HandleQLoggingGUI(QtMsgType type, const QMessageLogContext &context, const QString &msg)
 {
@@ -114,6 +97,12 @@ void HandleQLogging(QtMsgType type, const QMessageLogContext &context, const QSt
     }
 }
 
+void HandleQLoggingQuiet(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+{
+    // Headless runs only want to hear about problems.
+    if (QtDebugMsg != type && QtInfoMsg != type) { HandleQLogging(type, context, msg); }
+}
+
 void HandleNetLogging(std::string lMsg)
 {
     if (!lMsg.empty())
@@ -204,6 +193,12 @@ int main(int argc, char *argv[])
 {
     bool bUseGui = true;
     bool bShouldRun = true;
+    u32 uSimGames = 0;
+    u32 uSimDiceMax = 0xff;
+    u32 uSimBoardSize = 0;
+    u32 uSimThreads = 0;
+    u32 uSimSeed = 0;
+    bool bSimSeeded = false;
 
     // Setup the directory.
     g_cfgVars.msRootDir = argv[0];
@@ -236,24 +231,101 @@ int main(int argc, char *argv[])
                    "Switches:\n\t"
                    "-d,--debug\t-\tShow debugging messages.\n\t"
                    "-h,--help\t-\tShow this help\n\t"
-                   "-n,--nogui\t-\tDon't show a GUI (for servers).\n\n"
+                   "-i,--infection\t-\tMoves spread by infection instead of flooding.\n\t"
+                   "-n,--nogui\t-\tDon't show a GUI (for servers).\n\t"
+                   "-o,--odds <secs>\t-\tSeconds \"!odds\" spends working out the odds (default 2).\n\t"
+                   "-s,--simulate <games>\t-\tPlay that many games headless and print the results.\n\t"
+                   "   --dice <max>\t-\tMaximum dice roll of the simulated games (default 255).\n\t"
+                   "   --size <layers>\t-\tBoard size (honeycomb layers) of the simulated games (default 2).\n\t"
+                   "   --threads <num>\t-\tWorker threads to simulate on (default 0 = every core).\n\t"
+                   "   --seed <num>\t-\tSeed of the simulated dice, for repeatable batches (default: the clock).\n\t"
+                   "-w,--win <pct>\t-\tPercent of the board a color has to hold to win (default 75, 100 = last color standing).\n\n"
                    "(c) 2018 SquigglePuff Jr.\n"
                    "Version: %d.%d.%d\n", VER_STAGE, VER_MAJOR, VER_MINOR, VER_PATCH);
             bShouldRun = false;
         }
+        else if (!strcmp("-i", argv[iIdx]) || !strcmp("--infection", argv[iIdx]))
+        {
+            g_cfgVars.mbInfection = true;
+        }
         else if (!strcmp("-n", argv[iIdx]) || !strcmp("--nogui", argv[iIdx]))
         {
             bUseGui = false;
         }
+        else if ((!strcmp("-o", argv[iIdx]) || !strcmp("--odds", argv[iIdx])) && (iIdx + 1) < argc)
+        {
+            const float c_nSeconds = static_cast<float>(atof(argv[++iIdx]));
+            if (0.0f < c_nSeconds) { g_cfgVars.mnOddsBudget = std::min(c_nSeconds, ODDS_MAX_BUDGET); }
+        }
+        else if ((!strcmp("-s", argv[iIdx]) || !strcmp("--simulate", argv[iIdx])) && (iIdx + 1) < argc)
+        {
+            uSimGames = static_cast<u32>(std::max(0, atoi(argv[++iIdx])));
+        }
+        else if (!strcmp("--dice", argv[iIdx]) && (iIdx + 1) < argc)
+        {
+            const int c_iDiceMax = atoi(argv[++iIdx]);
+            if (3 <= c_iDiceMax)
+            {
+                uSimDiceMax = static_cast<u32>(c_iDiceMax);
+            }
+            else
+            {
+                fprintf(stderr, "ERR: Dice maximum must be at least 3! Keeping %u.\n", uSimDiceMax);
+            }
+        }
+        else if (!strcmp("--size", argv[iIdx]) && (iIdx + 1) < argc)
+        {
+            const int c_iBoardSize = atoi(argv[++iIdx]);
+            if (1 <= c_iBoardSize)
+            {
+                uSimBoardSize = static_cast<u32>(c_iBoardSize);
+            }
+            else
+            {
+                fprintf(stderr, "ERR: Board size must be at least 1 layer! Keeping the default.\n");
+            }
+        }
+        else if (!strcmp("--threads", argv[iIdx]) && (iIdx + 1) < argc)
+        {
+            uSimThreads = static_cast<u32>(std::max(0, atoi(argv[++iIdx])));
+        }
+        else if (!strcmp("--seed", argv[iIdx]) && (iIdx + 1) < argc)
+        {
+            uSimSeed = static_cast<u32>(strtoul(argv[++iIdx], nullptr, 0));
+            bSimSeeded = true;
+        }
+        else if ((!strcmp("-w", argv[iIdx]) || !strcmp("--win", argv[iIdx])) && (iIdx + 1) < argc)
+        {
+            const float c_nPercent = static_cast<float>(atof(argv[++iIdx]));
+            if (0.0f < c_nPercent && 100.0f >= c_nPercent)
+            {
+                g_cfgVars.mnWinShare = c_nPercent / 100.0f;
+            }
+            else
+            {
+                fprintf(stderr, "ERR: Win percentage must be above 0 and at most 100! Keeping %.0f%%.\n", g_cfgVars.mnWinShare * 100.0f);
+            }
+        }
     }
 
     int iRtnCode = 0;
-    if (bShouldRun)
+    if (bShouldRun && 0 < uSimGames)
+    {
+        // Headless batch, no window, event loop or log file.
+        qInstallMessageHandler(HandleQLoggingQuiet);
+
+        CSimulator lSimulator;
+        lSimulator.SetDiceMax(uSimDiceMax);
+        lSimulator.SetNumThreads(uSimThreads);
+        if (0 < uSimBoardSize) { lSimulator.SetBoardSize(uSimBoardSize); }
+        if (bSimSeeded) { lSimulator.SetSeed(uSimSeed); }
+        lSimulator.SetTemplateDir(QString::fromStdString(g_cfgVars.msRootDir + "/cache"));
+        CSimulator::PrintResults(lSimulator.Run(uSimGames));
+    }
+    else if (bShouldRun)
     {
         OpenLogAndPrintHeader();
 
-        SetupColorNames();
-
         QApplication a(argc, argv);
         pMainWnd = new CMainWindow();
 
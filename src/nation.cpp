@@ -1,15 +1,21 @@
 #include "include/nation.h"
 
-CNation::CNation() : meColor{Cell_White}, msName{"White"}
+CNation::CNation() : mpStore{nullptr}, muNumCells{0}, meColor{Cell_White}, msName{"White"}
 {
     // Intentionally left blank.
 }
 
-CNation::CNation(const CNation& aCls) : mvOwnedCells{aCls.mvOwnedCells}, meColor{aCls.meColor}, msName{aCls.msName}
+CNation::CNation(const CNation& aCls) : mpStore{aCls.mpStore}, mOwnedCells{aCls.mOwnedCells}, muNumCells{aCls.muNumCells}, meColor{aCls.meColor}, msName{aCls.msName}
 {
     // Intentionally left blank.
 }
 
+CNation::CNation(CNation&& aCls) noexcept : mpStore{aCls.mpStore}, mOwnedCells{std::move(aCls.mOwnedCells)}, muNumCells{aCls.muNumCells}, meColor{aCls.meColor},
+    msName{std::move(aCls.msName)}
+{
+    aCls.muNumCells = 0;
+}
+
 CNation::~CNation()
 {
     Destroy();
@@ -19,7 +25,9 @@ CNation& CNation::operator=(const CNation& aCls)
 {
     if (this != &aCls)
     {
-        mvOwnedCells = aCls.mvOwnedCells;
+        mpStore = aCls.mpStore;
+        mOwnedCells = aCls.mOwnedCells;
+        muNumCells = aCls.muNumCells;
         meColor = aCls.meColor;
         msName = aCls.msName;
     }
@@ -27,6 +35,21 @@ CNation& CNation::operator=(const CNation& aCls)
     return *this;
 }
 
+CNation& CNation::operator=(CNation&& aCls) noexcept
+{
+    if (this != &aCls)
+    {
+        mpStore = aCls.mpStore;
+        mOwnedCells = std::move(aCls.mOwnedCells);
+        muNumCells = aCls.muNumCells;
+        meColor = aCls.meColor;
+        msName = std::move(aCls.msName);
+        aCls.muNumCells = 0;
+    }
+
+    return *this;
+}
+
 CNation* CNation::operator <<(CNation& aChild)
 {
     return aChild.Merge(this);
@@ -37,27 +60,38 @@ CNation* CNation::operator >>(CNation& aParent)
     return Merge(&aParent);
 }
 
-void CNation::Create(ECellColors eClr, QString sName)
+/*!
+ * \brief CNation::Create
+ *
+ * Sets up the nation with no cells.
+ *
+ * \param eClr - Color of the nation.
+ * \param sName - Name of the nation.
+ * \param pStore - Cell store of the board the nation lives on, the nation's cell set is sized to it.
+ */
+void CNation::Create(ECellColors eClr, QString sName, CCellStore* pStore)
 {
     meColor = eClr;
     msName = sName;
+    mpStore = pStore;
+
+    mOwnedCells.Resize((nullptr != mpStore) ? mpStore->GetCount() : 0);
+    muNumCells = 0;
 }
 
 void CNation::Destroy()
 {
     // Simply purge the lists, do NOT delete anything as we do NOT own it!
-    mvOwnedCells.clear();
+    mOwnedCells.Clear();
+    muNumCells = 0;
 }
 
 bool CNation::Add(u64 uCellID)
 {
-    bool bSuccess = false;
+    const u32 uCellIdx = (nullptr != mpStore) ? mpStore->CoordToIndex(SHexCoord::FromID(uCellID)) : INVALID_CELL_IDX;
 
-    if (mvOwnedCells.end() == std::find(mvOwnedCells.begin(), mvOwnedCells.end(), uCellID))
-    {
-        mvOwnedCells.push_back(uCellID);
-    }
-    else
+    bool bSuccess = AddIndex(uCellIdx);
+    if (!bSuccess)
     {
         std::string sMsg = QString("ERR: We already own the cell with ID %1!").arg(uCellID).toStdString();
         qCritical(sMsg.c_str());
@@ -68,14 +102,10 @@ bool CNation::Add(u64 uCellID)
 
 bool CNation::Remove(u64 uCellID)
 {
-    bool bSuccess = false;
+    const u32 uCellIdx = (nullptr != mpStore) ? mpStore->CoordToIndex(SHexCoord::FromID(uCellID)) : INVALID_CELL_IDX;
 
-    std::vector<u64>::iterator iCellIter = std::find(mvOwnedCells.begin(), mvOwnedCells.end(), uCellID);
-    if (mvOwnedCells.end() != iCellIter)
-    {
-        mvOwnedCells.erase(iCellIter);
-    }
-    else
+    bool bSuccess = RemoveIndex(uCellIdx);
+    if (!bSuccess)
     {
         std::string sMsg = QString("ERR: We don't own the cell with ID %1!").arg(uCellID).toStdString();
         qCritical(sMsg.c_str());
@@ -84,11 +114,89 @@ bool CNation::Remove(u64 uCellID)
     return bSuccess;
 }
 
+/*!
+ * \brief CNation::AddIndex
+ *
+ * Adds a single cell by it's board cell index.
+ *
+ * \param uCellIdx - Cell index to add.
+ * \return True if the cell was added, false if it's already owned (or isn't a cell).
+ */
+bool CNation::AddIndex(u32 uCellIdx)
+{
+    if (mOwnedCells.GetSize() <= uCellIdx || mOwnedCells.Test(uCellIdx))
+    {
+        return false;
+    }
+
+    mOwnedCells.Set(uCellIdx);
+    ++muNumCells;
+
+    return true;
+}
+
+/*!
+ * \brief CNation::RemoveIndex
+ *
+ * Removes a single cell by it's board cell index.
+ *
+ * \param uCellIdx - Cell index to remove.
+ * \return True if the cell was removed, false if it wasn't owned.
+ */
+bool CNation::RemoveIndex(u32 uCellIdx)
+{
+    if (!mOwnedCells.Test(uCellIdx))
+    {
+        return false;
+    }
+
+    mOwnedCells.Reset(uCellIdx);
+    --muNumCells;
+
+    return true;
+}
+
+/*!
+ * \brief CNation::AddCells
+ *
+ * Adds a whole set of cells at once.
+ *
+ * \param aCells - Cells to add (already owned cells are skipped).
+ * \return Number of cells actually added.
+ */
+u32 CNation::AddCells(const CCellBitset& aCells)
+{
+    mOwnedCells.Or(aCells);
+
+    const u32 uOldCount = muNumCells;
+    muNumCells = mOwnedCells.Count();
+
+    return muNumCells - uOldCount;
+}
+
+/*!
+ * \brief CNation::RemoveCells
+ *
+ * Removes a whole set of cells at once.
+ *
+ * \param aCells - Cells to remove (cells that aren't owned are skipped).
+ * \return Number of cells actually removed.
+ */
+u32 CNation::RemoveCells(const CCellBitset& aCells)
+{
+    mOwnedCells.AndNot(aCells);
+
+    const u32 uOldCount = muNumCells;
+    muNumCells = mOwnedCells.Count();
+
+    return uOldCount - muNumCells;
+}
+
 // !! NOT USED FOR NOW !!
 CNation* CNation::Merge(CNation* pMother)
 {
     // We don't own them anymore!
-    mvOwnedCells.clear();
+    Destroy();
 
     // Done! Return the new mother!
     return pMother;
@@ -96,7 +204,7 @@ CNation* CNation::Merge(CNation* pMother)
 
 u32 CNation::GetNationSize()
 {
-    return mvOwnedCells.size();
+    return muNumCells;
 }
 
 ECellColors CNation::GetNationColor()
@@ -109,9 +217,14 @@ QString CNation::GetNationName()
     return msName;
 }
 
-std::vector<u64> CNation::GetCellIDs()
+const CCellBitset& CNation::GetCells()
+{
+    return mOwnedCells;
+}
+
+bool CNation::OwnsIndex(u32 uCellIdx)
 {
-    return mvOwnedCells;
+    return mOwnedCells.Test(uCellIdx);
 }
 
 void CNation::SetNationColor(ECellColors eColor)
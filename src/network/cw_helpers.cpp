@@ -4,11 +4,11 @@
 SCommand ParseCommandString(QString) { return SCommand(); }
 #endif // #if !defined(_EXTERN_CMDPARSE_FXN)
 
-QByteArray* PackBoardMap(std::map<u64, ECellColors> mData)
+QByteArray* PackBoardMap(const std::map<u64, ECellColors>& mData)
 {
     QByteArray* pRtn = new QByteArray();
 
-    for (std::map<u64, ECellColors>::iterator pIter = mData.begin(); pIter != mData.end(); ++pIter)
+    for (std::map<u64, ECellColors>::const_iterator pIter = mData.begin(); pIter != mData.end(); ++pIter)
     {
         std::pair<u64, ECellColors> lTmpPair = (*pIter);
 
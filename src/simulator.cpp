@@ -0,0 +1,391 @@
+#include "include/simulator.h"
+
+/*!
+ * \brief SSimResults::Merge
+ *
+ * This method adds another batch's totals to this one.
+ *
+ * \param aOther - Totals to add.
+ */
+void SSimResults::Merge(const SSimResults& aOther)
+{
+    const u32 c_uFinished = muGames - muUnfinished;
+    const u32 c_uOtherFinished = aOther.muGames - aOther.muUnfinished;
+    if (0 < c_uOtherFinished)
+    {
+        muMinRolls = (0 < c_uFinished) ? std::min(muMinRolls, aOther.muMinRolls) : aOther.muMinRolls;
+        muMaxRolls = std::max(muMaxRolls, aOther.muMaxRolls);
+    }
+
+    muGames += aOther.muGames;
+    muUnfinished += aOther.muUnfinished;
+    muRolls += aOther.muRolls;
+    muMoves += aOther.muMoves;
+    for (u32 uClr = 0; NUM_CELL_COLORS > uClr; ++uClr) { mvWins[uClr] += aOther.mvWins[uClr]; }
+}
+
+/*!
+ * \brief SSimResults::GetWinInterval
+ *
+ * This method works out the confidence interval (SIM_CONFIDENCE_Z) of a color's chance of winning, from the share of the games it won. It's the Wilson score
+ * interval, which stays sensible for colors that won (almost) none or all of the games, unlike the plain "share +/- error" interval.
+ *
+ * \param[in] uClr - Palette index of the color.
+ * \param[out] nLow - Receives the low end of the interval [0 - 1].
+ * \param[out] nHigh - Receives the high end of the interval [0 - 1].
+ */
+void SSimResults::GetWinInterval(u8 uClr, double& nLow, double& nHigh) const
+{
+    nLow = 0.0;
+    nHigh = 1.0;
+    if (0 == muGames || NUM_CELL_COLORS <= uClr) { return; }
+
+    const double c_nGames = static_cast<double>(muGames);
+    const double c_nShare = static_cast<double>(mvWins[uClr]) / c_nGames;
+    const double c_nZ2 = SIM_CONFIDENCE_Z * SIM_CONFIDENCE_Z;
+    const double c_nScale = 1.0 + c_nZ2 / c_nGames;
+
+    const double c_nCenter = (c_nShare + c_nZ2 / (2.0 * c_nGames)) / c_nScale;
+    const double c_nSpread = SIM_CONFIDENCE_Z * sqrt(c_nShare * (1.0 - c_nShare) / c_nGames + c_nZ2 / (4.0 * c_nGames * c_nGames)) / c_nScale;
+
+    nLow = std::max(0.0, c_nCenter - c_nSpread);
+    nHigh = std::min(1.0, c_nCenter + c_nSpread);
+}
+
+CSimulator::CSimulator() : muBoardSize{2}, muCellSz{SIM_CELL_SZ}, mCenter{SPoint(SIM_CENTER, SIM_CENTER)}, muDiceMax{0xff}, muMaxRolls{SIM_MAX_ROLLS}, muNumThreads{0},
+    muSeed{static_cast<u32>(clock())}, msTemplateDir{""}, mbFinished{false}, mbCancelled{false}
+{
+    // Intentionally left blank.
+}
+
+CSimulator::~CSimulator()
+{
+    Cancel();
+    if (mRunner.joinable()) { mRunner.join(); }
+
+    DestroyBoards();
+}
+
+/*!
+ * \brief CSimulator::CreateBoards
+ *
+ * This method makes the worker boards, one per worker. The first one generates (and caches) the board template if it isn't cached yet, the rest map it straight
+ * in. Boards that already exist are kept, so this only does work the first time or after the board settings changed.
+ *
+ * The boards are headless (see CBoard::SetHeadless): they don't log, so this is safe on any thread (RunAsync leaves it to the batch's own thread), and they skip
+ * the territory tracking the games never look at.
+ */
+void CSimulator::CreateBoards()
+{
+    const u32 c_uNumBoards = std::max(1u, (0 < muNumThreads) ? muNumThreads : std::thread::hardware_concurrency());
+    while (c_uNumBoards > mvBoards.size())
+    {
+        CBoard* pBoard = new CBoard();
+        pBoard->SetHeadless(true);
+        pBoard->SetBoardSize(muBoardSize);
+        pBoard->SetTemplateDir(msTemplateDir);
+        pBoard->SetMaxThreads(1); // The workers already keep every core busy.
+        pBoard->Create(muCellSz, mCenter);
+
+        if (nullptr == mpFreshState) { mpFreshState = pBoard->GetSnapshot(); }
+        mvBoards.push_back(pBoard);
+    }
+}
+
+/*!
+ * \brief CSimulator::Run
+ *
+ * This function plays a batch of games over the worker pool and returns their totals. Games are handed out one at a time until "uNumGames" have been played or
+ * the time budget runs out, games still being played then are dropped.
+ *
+ * \param uNumGames - Most games to play.
+ * \param nTimeBudget - Most seconds to spend, 0 for no limit.
+ * \return Totals of the batch.
+ */
+SSimResults CSimulator::Run(u32 uNumGames, double nTimeBudget)
+{
+    const std::chrono::steady_clock::time_point c_tStart = std::chrono::steady_clock::now();
+    const std::chrono::steady_clock::time_point c_tDeadline = (0.0 < nTimeBudget)
+        ? c_tStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(nTimeBudget))
+        : std::chrono::steady_clock::time_point::max();
+
+    CreateBoards();
+
+    const u32 c_uNumThreads = std::max(1u, std::min(uNumGames, static_cast<u32>(mvBoards.size())));
+    std::vector<SSimResults> vResults(c_uNumThreads);
+    std::atomic<u32> uNextGame(0);
+
+    std::vector<std::thread> vWorkers;
+    vWorkers.reserve(c_uNumThreads);
+    for (u32 uWorker = 0; c_uNumThreads > uWorker; ++uWorker)
+    {
+        vWorkers.push_back(std::thread(&CSimulator::PlayGames, this, uWorker, uNumGames, c_tDeadline, &uNextGame, &vResults[uWorker]));
+    }
+
+    SSimResults lTotals;
+    for (u32 uWorker = 0; c_uNumThreads > uWorker; ++uWorker)
+    {
+        vWorkers[uWorker].join();
+        lTotals.Merge(vResults[uWorker]);
+    }
+
+    lTotals.mnSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - c_tStart).count();
+    return lTotals;
+}
+
+/*!
+ * \brief CSimulator::RunAsync
+ *
+ * This function starts a batch (see Run) on a thread of it's own and returns straight away, the totals are collected with PollResults. The worker boards are made
+ * on that thread too, so the caller never waits on them.
+ *
+ * \param uNumGames - Most games to play.
+ * \param nTimeBudget - Most seconds to spend, 0 for no limit.
+ * \return True if the batch was started, false if the last one hasn't been collected yet.
+ */
+bool CSimulator::RunAsync(u32 uNumGames, double nTimeBudget)
+{
+    if (mRunner.joinable()) { return false; }
+
+    mbFinished = false;
+    mbCancelled = false;
+    mRunner = std::thread(&CSimulator::RunInBackground, this, uNumGames, nTimeBudget);
+
+    return true;
+}
+
+/*!
+ * \brief CSimulator::PollResults
+ *
+ * This function collects the totals of a batch started with RunAsync, once it's finished. It never waits.
+ *
+ * \param aResults - Receives the totals.
+ * \return True if the batch finished (and "aResults" was filled in), false if it's still running or there's no batch.
+ */
+bool CSimulator::PollResults(SSimResults& aResults)
+{
+    if (!mRunner.joinable() || !mbFinished) { return false; }
+
+    mRunner.join();
+    aResults = mAsyncResults;
+
+    return true;
+}
+
+/*!
+ * \brief CSimulator::Cancel
+ *
+ * This method asks the running batch to stop, it finishes as if it ran out of time.
+ */
+void CSimulator::Cancel()
+{
+    mbCancelled = true;
+}
+
+/*!
+ * \brief CSimulator::PrintResults
+ *
+ * This method prints a batch's totals: throughput, game lengths and how often each color won.
+ *
+ * \param aResults - Totals to print.
+ */
+void CSimulator::PrintResults(const SSimResults& aResults)
+{
+    const double c_nSeconds = (0.0 < aResults.mnSeconds) ? aResults.mnSeconds : 1.0;
+    const u32 c_uFinished = aResults.muGames - aResults.muUnfinished;
+
+    printf("Simulated %u games in %.2fs (%.1f games/sec).\n", aResults.muGames, aResults.mnSeconds, aResults.muGames / c_nSeconds);
+    printf("Rolls: %llu (%.0f/sec), Moves: %llu (%.0f/sec).\n", aResults.muRolls, aResults.muRolls / c_nSeconds, aResults.muMoves, aResults.muMoves / c_nSeconds);
+    if (0 < c_uFinished)
+    {
+        printf("Game length: %llu - %llu rolls (%.1f average).\n", aResults.muMinRolls, aResults.muMaxRolls,
+               static_cast<double>(aResults.muRolls) / static_cast<double>(aResults.muGames));
+    }
+
+    printf("Wins:\n");
+    for (u8 uClr = 0; NUM_CELL_COLORS > uClr; ++uClr)
+    {
+        if (0 == aResults.mvWins[uClr]) { continue; }
+
+        double nLow = 0.0;
+        double nHigh = 0.0;
+        aResults.GetWinInterval(uClr, nLow, nHigh);
+        printf("\t%-8s %6u (%.1f%%, %.1f - %.1f%%)\n", c_ColorPalette[uClr].pName, aResults.mvWins[uClr], 100.0 * aResults.mvWins[uClr] / std::max(1u, aResults.muGames),
+               100.0 * nLow, 100.0 * nHigh);
+    }
+
+    if (0 < aResults.muUnfinished) { printf("\t%-8s %6u (ran out of rolls)\n", "None", aResults.muUnfinished); }
+}
+
+bool CSimulator::IsRunning()
+{
+    return mRunner.joinable();
+}
+
+void CSimulator::SetBoardSize(u32 uSize)
+{
+    if (muBoardSize != uSize) { DestroyBoards(); }
+    muBoardSize = uSize;
+}
+
+void CSimulator::SetCellSize(u32 uCellSz)
+{
+    if (muCellSz != uCellSz) { DestroyBoards(); }
+    muCellSz = uCellSz;
+}
+
+void CSimulator::SetCanvasCenter(SPoint aPt)
+{
+    if (mCenter.mX != aPt.mX || mCenter.mY != aPt.mY) { DestroyBoards(); }
+    mCenter = aPt;
+}
+
+void CSimulator::SetDiceMax(u32 uDiceMax)
+{
+    muDiceMax = uDiceMax;
+}
+
+void CSimulator::SetMaxRolls(u32 uMaxRolls)
+{
+    muMaxRolls = uMaxRolls;
+}
+
+void CSimulator::SetNumThreads(u32 uNumThreads)
+{
+    muNumThreads = uNumThreads;
+}
+
+void CSimulator::SetSeed(u32 uSeed)
+{
+    muSeed = uSeed;
+}
+
+/*!
+ * \brief CSimulator::SetStartState
+ *
+ * This method sets the cell state every game starts from. The snapshot is shared by the workers (it's never written to), so it costs nothing to hand over.
+ *
+ * \param pState - Cell state of a board with the same layout as the simulated ones, nullptr to start from a fresh board.
+ */
+void CSimulator::SetStartState(std::shared_ptr<const CCellSnapshot> pState)
+{
+    mpStartState = pState;
+}
+
+void CSimulator::SetTemplateDir(const QString& sDir)
+{
+    if (msTemplateDir != sDir) { DestroyBoards(); }
+    msTemplateDir = sDir;
+}
+
+/*!
+ * \brief CSimulator::DestroyBoards
+ *
+ * This method frees the worker boards, they're made again by the next batch.
+ */
+void CSimulator::DestroyBoards()
+{
+    for (std::vector<CBoard*>::iterator pIter = mvBoards.begin(); pIter != mvBoards.end(); ++pIter)
+    {
+        delete (*pIter);
+    }
+
+    mvBoards.clear();
+    mpFreshState.reset();
+}
+
+/*!
+ * \brief CSimulator::RunInBackground
+ *
+ * This method is the body of a RunAsync thread, it makes any worker boards that are missing (see CreateBoards) and plays the batch.
+ */
+void CSimulator::RunInBackground(u32 uNumGames, double nTimeBudget)
+{
+    mAsyncResults = Run(uNumGames, nTimeBudget);
+    mbFinished = true;
+}
+
+/*!
+ * \brief CSimulator::PlayGames
+ *
+ * This method is a worker: it keeps taking the next game number and playing that game out on it's own board until the batch is done, runs out of time or is
+ * cancelled. Each roll goes through the same rules as CGame::Play.
+ *
+ * \param uWorker - Index of the worker (picks it's board and dice seed).
+ * \param uNumGames - Number of games in the batch.
+ * \param tDeadline - Time the batch has to stop by.
+ * \param pNextGame - Next game number to play, shared by the workers.
+ * \param pResults - Receives the worker's totals.
+ */
+void CSimulator::PlayGames(u32 uWorker, u32 uNumGames, std::chrono::steady_clock::time_point tDeadline, std::atomic<u32>* pNextGame, SSimResults* pResults)
+{
+    CBoard* pBoard = mvBoards[uWorker];
+    const std::shared_ptr<const CCellSnapshot> pStart = (nullptr != mpStartState) ? mpStartState : mpFreshState;
+
+    CDice lDice(muSeed + uWorker);
+    CRandomPolicy lPolicy;
+    SSimResults lResults;
+
+    bool bStopped = false;
+    for (u32 uGame = (*pNextGame)++; uNumGames > uGame && !bStopped; uGame = (*pNextGame)++)
+    {
+        if (mbCancelled || std::chrono::steady_clock::now() >= tDeadline || nullptr == pStart || !pBoard->LoadColors(*pStart)) { break; }
+
+        ECellColors eWinner = Comb_Mixed;
+        ECellColors eAggressor = Comb_Mixed;
+        ECellColors eVictim = Comb_Mixed;
+        u64 uRolls = 0;
+        while (Comb_Mixed == eWinner && muMaxRolls > uRolls && lPolicy.PickMove(*pBoard, lDice, eAggressor, eVictim))
+        {
+            ++uRolls;
+
+            // Long games check in every so often so the batch can keep to it's time budget.
+            if (0 == uRolls % SIM_DEADLINE_ROLLS && (mbCancelled || std::chrono::steady_clock::now() >= tDeadline))
+            {
+                bStopped = true;
+                break;
+            }
+
+            u32 uMvAmnt = 0;
+            if (CGame::RollToMove(lDice.Roll(3, muDiceMax), muDiceMax, uMvAmnt))
+            {
+                if (0 == uMvAmnt) { uMvAmnt = pBoard->GetColorCount(eVictim); }
+
+                u32 uTaken = 0;
+                if (g_cfgVars.mbInfection)
+                {
+                    float nChance = 0.0f;
+                    u64 uSeed = 0;
+                    CGame::RollInfection(lDice, muDiceMax, nChance, uSeed);
+                    uTaken = pBoard->Infect(eAggressor, eVictim, nChance, uSeed, uMvAmnt);
+                }
+                else
+                {
+                    uTaken = pBoard->FloodFill(eAggressor, eVictim, uMvAmnt);
+                }
+
+                if (0 < uTaken) { ++lResults.muMoves; }
+            }
+
+            eWinner = CGame::FindWinner(pBoard, eAggressor);
+        }
+
+        // A game cut short by the deadline doesn't count.
+        if (bStopped) { break; }
+
+        ++lResults.muGames;
+        lResults.muRolls += uRolls;
+        if (Comb_Mixed != eWinner)
+        {
+            lResults.muMinRolls = (lResults.muGames - lResults.muUnfinished > 1) ? std::min(lResults.muMinRolls, uRolls) : uRolls;
+            lResults.muMaxRolls = std::max(lResults.muMaxRolls, uRolls);
+            ++lResults.mvWins[ColorToPalette(eWinner)];
+        }
+        else
+        {
+            ++lResults.muUnfinished;
+        }
+    }
+
+    (*pResults) = lResults;
+}
@@ -0,0 +1,453 @@
+#include <algorithm>
+#include "include/territory.h"
+
+CTerritories::CTerritories() : mpStore{nullptr}, muNumValidCells{0}, muStamp{0}
+{
+    // Intentionally left blank.
+}
+
+CTerritories::CTerritories(const CTerritories& aCls) : mpStore{nullptr}, muNumValidCells{0}, muStamp{0}
+{
+    (*this) = aCls;
+}
+
+CTerritories::~CTerritories()
+{
+    Destroy();
+}
+
+CTerritories& CTerritories::operator=(const CTerritories& aCls)
+{
+    if (this != &aCls)
+    {
+        mpStore = aCls.mpStore;
+        mvCellLabels = aCls.mvCellLabels;
+        mvLabelParent = aCls.mvLabelParent;
+        mvLabelSize = aCls.mvLabelSize;
+        mvLabelColor = aCls.mvLabelColor;
+        mvTerritorySizes = aCls.mvTerritorySizes;
+        muNumValidCells = aCls.muNumValidCells;
+        mvVisitStamps = aCls.mvVisitStamps;
+        muStamp = aCls.muStamp;
+        mvEvents = aCls.mvEvents;
+    }
+
+    return *this;
+}
+
+/*!
+ * \brief CTerritories::Build
+ *
+ * This method labels every territory of the board from scratch with a flood fill per territory. It's run once when the board is set up (and again whenever the
+ * labels need compacting), everything after that is kept up to date by "CellRecolored".
+ *
+ * \note Pending events are left alone.
+ *
+ * \param pStore - Cell store of the board.
+ */
+void CTerritories::Build(CCellStore* pStore)
+{
+    mpStore = pStore;
+    mvLabelParent.clear();
+    mvLabelSize.clear();
+    mvLabelColor.clear();
+    mvTerritorySizes.assign(NUM_CELL_COLORS, std::multiset<u32>());
+    muNumValidCells = 0;
+
+    const u32 c_uNumCells = (nullptr != mpStore) ? mpStore->GetCount() : 0;
+    mvCellLabels.assign(c_uNumCells, INVALID_CELL_IDX);
+    mvVisitStamps.assign(c_uNumCells, 0);
+    muStamp = 0;
+
+    std::vector<u32>& vQueue = mvSearchQueues[0];
+    u32 pNeighbors[NUM_HEX_VERTS];
+    for (u32 uCellIdx = 0; c_uNumCells > uCellIdx; ++uCellIdx)
+    {
+        if (INVALID_CELL_IDX != mvCellLabels[uCellIdx] || !mpStore->IsValid(uCellIdx)) { continue; }
+
+        const u8 c_uClr = mpStore->GetColorIdx(uCellIdx);
+        const u32 c_uLabel = NewLabel(c_uClr, 0);
+
+        vQueue.clear();
+        vQueue.push_back(uCellIdx);
+        mvCellLabels[uCellIdx] = c_uLabel;
+        for (size_t uHead = 0; vQueue.size() > uHead; ++uHead)
+        {
+            const u32 c_uNumNeighbors = mpStore->GetNeighborIndices(vQueue[uHead], pNeighbors);
+            for (u32 uNeigh = 0; c_uNumNeighbors > uNeigh; ++uNeigh)
+            {
+                if (INVALID_CELL_IDX == mvCellLabels[pNeighbors[uNeigh]] && c_uClr == mpStore->GetColorIdx(pNeighbors[uNeigh]))
+                {
+                    mvCellLabels[pNeighbors[uNeigh]] = c_uLabel;
+                    vQueue.push_back(pNeighbors[uNeigh]);
+                }
+            }
+        }
+
+        mvLabelSize[c_uLabel] = static_cast<u32>(vQueue.size());
+        if (NUM_CELL_COLORS > c_uClr) { mvTerritorySizes[c_uClr].insert(mvLabelSize[c_uLabel]); }
+        muNumValidCells += mvLabelSize[c_uLabel];
+    }
+}
+
+/*!
+ * \brief CTerritories::Destroy
+ *
+ * This method drops every territory.
+ */
+void CTerritories::Destroy()
+{
+    mpStore = nullptr;
+    mvCellLabels.clear();
+    mvLabelParent.clear();
+    mvLabelSize.clear();
+    mvLabelColor.clear();
+    mvTerritorySizes.clear();
+    muNumValidCells = 0;
+    mvVisitStamps.clear();
+    muStamp = 0;
+    mvEvents.clear();
+}
+
+/*!
+ * \brief CTerritories::CellRecolored
+ *
+ * This method moves a cell from the territory of it's old color to the territory of it's new one. It must be called after the cell store has the new color.
+ *
+ * \param uCellIdx - Index of the cell.
+ * \param eOldClr - Color the cell had.
+ * \param eNewClr - Color the cell has now.
+ */
+void CTerritories::CellRecolored(u32 uCellIdx, ECellColors eOldClr, ECellColors eNewClr)
+{
+    const u8 c_uOldClr = ColorToPalette(eOldClr);
+    const u8 c_uNewClr = ColorToPalette(eNewClr);
+    if (mvCellLabels.size() <= uCellIdx || INVALID_CELL_IDX == mvCellLabels[uCellIdx] || c_uOldClr == c_uNewClr) { return; }
+
+    CellLost(uCellIdx, c_uOldClr);
+    CellGained(uCellIdx, c_uNewClr);
+
+    // Every gain adds a label and every split adds more, relabel once the dead ones dwarf the board.
+    if (mvLabelParent.size() > 4 * static_cast<size_t>(muNumValidCells) + 1024) { Build(mpStore); }
+}
+
+void CTerritories::ClearEvents()
+{
+    mvEvents.clear();
+}
+
+/*!
+ * \brief CTerritories::GetTerritory
+ *
+ * This function returns the territory a cell is in. The value is only meaningful until the next change, use it to compare cells.
+ *
+ * \param uCellIdx - Index of the cell.
+ * \return Territory (root label) of the cell, INVALID_CELL_IDX if the cell doesn't exist.
+ */
+u32 CTerritories::GetTerritory(u32 uCellIdx)
+{
+    return (mvCellLabels.size() > uCellIdx && INVALID_CELL_IDX != mvCellLabels[uCellIdx]) ? FindRoot(mvCellLabels[uCellIdx]) : INVALID_CELL_IDX;
+}
+
+u32 CTerritories::GetTerritorySize(u32 uCellIdx)
+{
+    const u32 c_uRoot = GetTerritory(uCellIdx);
+    return (INVALID_CELL_IDX != c_uRoot) ? mvLabelSize[c_uRoot] : 0;
+}
+
+bool CTerritories::SameTerritory(u32 uCellIdxA, u32 uCellIdxB)
+{
+    const u32 c_uRootA = GetTerritory(uCellIdxA);
+    return (INVALID_CELL_IDX != c_uRootA && c_uRootA == GetTerritory(uCellIdxB));
+}
+
+/*!
+ * \brief CTerritories::GetTerritoryCount
+ *
+ * This function returns how many separate territories a color has.
+ *
+ * \param eClr - Color to check.
+ * \return Number of territories of the color.
+ */
+u32 CTerritories::GetTerritoryCount(ECellColors eClr)
+{
+    const u8 c_uClr = ColorToPalette(eClr);
+    return (mvTerritorySizes.size() > c_uClr) ? static_cast<u32>(mvTerritorySizes[c_uClr].size()) : 0;
+}
+
+/*!
+ * \brief CTerritories::GetLargestTerritory
+ *
+ * This function returns the size of a color's largest territory.
+ *
+ * \param eClr - Color to check.
+ * \return Number of cells in the largest territory of the color, 0 if it has none.
+ */
+u32 CTerritories::GetLargestTerritory(ECellColors eClr)
+{
+    const u8 c_uClr = ColorToPalette(eClr);
+    return (mvTerritorySizes.size() > c_uClr && !mvTerritorySizes[c_uClr].empty()) ? *mvTerritorySizes[c_uClr].rbegin() : 0;
+}
+
+/*!
+ * \brief CTerritories::GetEvents
+ *
+ * This function returns the merges and splits that happened since the last "ClearEvents", oldest first.
+ *
+ * \return The territory events.
+ */
+const std::vector<STerritoryEvent>& CTerritories::GetEvents()
+{
+    return mvEvents;
+}
+
+u32 CTerritories::NewLabel(u8 uClr, u32 uSize)
+{
+    const u32 c_uLabel = static_cast<u32>(mvLabelParent.size());
+    mvLabelParent.push_back(c_uLabel);
+    mvLabelSize.push_back(uSize);
+    mvLabelColor.push_back(uClr);
+
+    return c_uLabel;
+}
+
+u32 CTerritories::FindRoot(u32 uLabel)
+{
+    while (mvLabelParent[uLabel] != uLabel)
+    {
+        mvLabelParent[uLabel] = mvLabelParent[mvLabelParent[uLabel]]; // Path halving.
+        uLabel = mvLabelParent[uLabel];
+    }
+
+    return uLabel;
+}
+
+/*!
+ * \brief CTerritories::Union
+ *
+ * This function joins two territories (given by their roots), hanging the smaller under the larger.
+ *
+ * \return Root of the joined territory.
+ */
+u32 CTerritories::Union(u32 uRootA, u32 uRootB)
+{
+    if (uRootA == uRootB) { return uRootA; }
+    if (mvLabelSize[uRootA] < mvLabelSize[uRootB]) { std::swap(uRootA, uRootB); }
+
+    const u32 c_uSizeB = mvLabelSize[uRootB];
+    ResizeTerritory(uRootB, 0);
+    ResizeTerritory(uRootA, mvLabelSize[uRootA] + c_uSizeB);
+    mvLabelParent[uRootB] = uRootA;
+
+    return uRootA;
+}
+
+void CTerritories::ResizeTerritory(u32 uRoot, u32 uNewSize)
+{
+    const u8 c_uClr = mvLabelColor[uRoot];
+    if (NUM_CELL_COLORS > c_uClr)
+    {
+        std::multiset<u32>& lSizes = mvTerritorySizes[c_uClr];
+        std::multiset<u32>::iterator pSizeIter = lSizes.find(mvLabelSize[uRoot]);
+        if (lSizes.end() != pSizeIter) { lSizes.erase(pSizeIter); }
+        if (0 < uNewSize) { lSizes.insert(uNewSize); }
+    }
+
+    mvLabelSize[uRoot] = uNewSize;
+}
+
+/*!
+ * \brief CTerritories::CellGained
+ *
+ * This method gives a cell a territory of it's own and joins it with the territory of every neighbor of the same color.
+ */
+void CTerritories::CellGained(u32 uCellIdx, u8 uClr)
+{
+    u32 uRoot = NewLabel(uClr, 0);
+    ResizeTerritory(uRoot, 1);
+    mvCellLabels[uCellIdx] = uRoot;
+
+    u32 uNumJoined = 0;
+    u32 pNeighbors[NUM_HEX_VERTS];
+    const u32 c_uNumNeighbors = mpStore->GetNeighborIndices(uCellIdx, pNeighbors);
+    for (u32 uNeigh = 0; c_uNumNeighbors > uNeigh; ++uNeigh)
+    {
+        if (uClr != mpStore->GetColorIdx(pNeighbors[uNeigh])) { continue; }
+
+        const u32 c_uNeighRoot = FindRoot(mvCellLabels[pNeighbors[uNeigh]]);
+        if (c_uNeighRoot != uRoot)
+        {
+            uRoot = Union(uRoot, c_uNeighRoot);
+            ++uNumJoined;
+        }
+    }
+
+    if (1 < uNumJoined)
+    {
+        STerritoryEvent lEvent;
+        lEvent.meColor = PaletteToColor(uClr);
+        lEvent.meChange = Territory_Merged;
+        lEvent.muCount = uNumJoined;
+        mvEvents.push_back(lEvent);
+    }
+}
+
+/*!
+ * \brief CTerritories::CellLost
+ *
+ * This method takes a cell out of it's territory, splitting the territory if the cell was holding it together.
+ *
+ * The neighbors still holding the color are grouped into runs going around the cell (neighbors next to each other in direction order touch, so a run is always
+ * connected). With a single run nothing can have split. Otherwise a breadth-first search is started from each run and the searches are stepped one cell at a time
+ * in turn. Searches that run into each other are joined, and a group of searches that runs out of cells has found a piece that got cut off, which is given a new
+ * territory. This ends once a single group is left, which keeps the old territory.
+ */
+void CTerritories::CellLost(u32 uCellIdx, u8 uClr)
+{
+    const u32 c_uRoot = FindRoot(mvCellLabels[uCellIdx]);
+    const u32 c_uOldSize = mvLabelSize[c_uRoot];
+
+    // Find the neighbors still holding the color, and the first cell of each run of them.
+    const u8 c_uNeighMask = mpStore->GetNeighborMask(uCellIdx);
+    u32 uSameMask = 0;
+    for (u32 uDir = 0; NUM_HEX_VERTS > uDir; ++uDir)
+    {
+        const u32 c_uNeighIdx = static_cast<u32>(static_cast<s64>(uCellIdx) + mpStore->GetDirShift(uDir));
+        if (0 != (c_uNeighMask & (1 << uDir)) && uClr == mpStore->GetColorIdx(c_uNeighIdx)) { uSameMask |= (1 << uDir); }
+    }
+
+    u32 auStarts[TERRITORY_MAX_ARCS];
+    u32 uNumRuns = 0;
+    for (u32 uDir = 0; NUM_HEX_VERTS > uDir; ++uDir)
+    {
+        const u32 c_uPrevDir = (uDir + NUM_HEX_VERTS - 1) % NUM_HEX_VERTS;
+        if (0 != (uSameMask & (1 << uDir)) && 0 == (uSameMask & (1 << c_uPrevDir)))
+        {
+            auStarts[uNumRuns++] = static_cast<u32>(static_cast<s64>(uCellIdx) + mpStore->GetDirShift(uDir));
+        }
+    }
+
+    if (2 > uNumRuns)
+    {
+        ResizeTerritory(c_uRoot, c_uOldSize - 1);
+        return;
+    }
+
+    // Step the searches in turn until one group of them is left.
+    const u32 c_uStamp = NextStamp();
+    u32 auGroup[TERRITORY_MAX_ARCS];
+    size_t auHead[TERRITORY_MAX_ARCS];
+    bool abClosed[TERRITORY_MAX_ARCS];
+    for (u32 uRun = 0; uNumRuns > uRun; ++uRun)
+    {
+        auGroup[uRun] = uRun;
+        auHead[uRun] = 0;
+        abClosed[uRun] = false;
+        mvSearchQueues[uRun].clear();
+        mvSearchQueues[uRun].push_back(auStarts[uRun]);
+        mvVisitStamps[auStarts[uRun]] = c_uStamp + uRun;
+    }
+
+    u32 uNumActive = uNumRuns;
+    u32 uNumPieces = 1;
+    u32 uSplitCells = 0;
+    u32 pNeighbors[NUM_HEX_VERTS];
+    while (1 < uNumActive)
+    {
+        for (u32 uRun = 0; uNumRuns > uRun && 1 < uNumActive; ++uRun)
+        {
+            const u32 c_uGroup = auGroup[uRun];
+            if (abClosed[c_uGroup]) { continue; }
+
+            // Expand one cell.
+            std::vector<u32>& vQueue = mvSearchQueues[uRun];
+            if (vQueue.size() > auHead[uRun])
+            {
+                const u32 c_uNumNeighbors = mpStore->GetNeighborIndices(vQueue[auHead[uRun]++], pNeighbors);
+                for (u32 uNeigh = 0; c_uNumNeighbors > uNeigh; ++uNeigh)
+                {
+                    const u32 c_uNeighIdx = pNeighbors[uNeigh];
+                    if (uClr != mpStore->GetColorIdx(c_uNeighIdx) || c_uStamp + uRun == mvVisitStamps[c_uNeighIdx]) { continue; }
+
+                    if (c_uStamp <= mvVisitStamps[c_uNeighIdx] && c_uStamp + uNumRuns > mvVisitStamps[c_uNeighIdx])
+                    {
+                        // Ran into another search, the two are in the same piece.
+                        const u32 c_uOtherGroup = auGroup[mvVisitStamps[c_uNeighIdx] - c_uStamp];
+                        if (c_uOtherGroup != c_uGroup)
+                        {
+                            for (u32 uOther = 0; uNumRuns > uOther; ++uOther) { if (c_uOtherGroup == auGroup[uOther]) { auGroup[uOther] = c_uGroup; } }
+                            --uNumActive;
+                        }
+                        continue;
+                    }
+
+                    mvVisitStamps[c_uNeighIdx] = c_uStamp + uRun;
+                    vQueue.push_back(c_uNeighIdx);
+                }
+            }
+
+            // Has the group run out of cells?
+            bool bExhausted = true;
+            for (u32 uOther = 0; uNumRuns > uOther && bExhausted; ++uOther)
+            {
+                bExhausted = (c_uGroup != auGroup[uOther] || mvSearchQueues[uOther].size() == auHead[uOther]);
+            }
+
+            if (bExhausted && 1 < uNumActive)
+            {
+                // Cut off, everything the group found becomes a new territory.
+                const u32 c_uLabel = NewLabel(uClr, 0);
+                u32 uPieceSize = 0;
+                for (u32 uOther = 0; uNumRuns > uOther; ++uOther)
+                {
+                    if (c_uGroup != auGroup[uOther]) { continue; }
+
+                    for (std::vector<u32>::iterator pCellIter = mvSearchQueues[uOther].begin(); pCellIter != mvSearchQueues[uOther].end(); ++pCellIter)
+                    {
+                        mvCellLabels[*pCellIter] = c_uLabel;
+                    }
+                    uPieceSize += static_cast<u32>(mvSearchQueues[uOther].size());
+                }
+
+                ResizeTerritory(c_uLabel, uPieceSize);
+                abClosed[c_uGroup] = true;
+                uSplitCells += uPieceSize;
+                ++uNumPieces;
+                --uNumActive;
+            }
+        }
+    }
+
+    ResizeTerritory(c_uRoot, c_uOldSize - 1 - uSplitCells);
+
+    if (1 < uNumPieces)
+    {
+        STerritoryEvent lEvent;
+        lEvent.meColor = PaletteToColor(uClr);
+        lEvent.meChange = Territory_Split;
+        lEvent.muCount = uNumPieces;
+        mvEvents.push_back(lEvent);
+    }
+}
+
+/*!
+ * \brief CTerritories::NextStamp
+ *
+ * This function hands out TERRITORY_MAX_ARCS fresh visit stamps (the returned one and the ones after it), so a search never has to clear what the last one
+ * visited. The stamps are only reset when they run out.
+ *
+ * \return First of the fresh stamps.
+ */
+u32 CTerritories::NextStamp()
+{
+    if (0xffffffff - TERRITORY_MAX_ARCS <= muStamp)
+    {
+        std::fill(mvVisitStamps.begin(), mvVisitStamps.end(), 0);
+        muStamp = 0;
+    }
+
+    const u32 c_uStamp = muStamp + 1;
+    muStamp += TERRITORY_MAX_ARCS;
+
+    return c_uStamp;
+}
@@ -0,0 +1,101 @@
+#include "include/workerpool.h"
+
+/*!
+ * \brief CWorkerPool::CWorkerPool
+ *
+ * Starts the worker threads, they sleep until "Run" hands them something to do.
+ *
+ * \param uNumWorkers - Number of threads to start, on top of the thread calling "Run".
+ */
+CWorkerPool::CWorkerPool(u32 uNumWorkers) : mpJob{nullptr}, muNumJobs{0}, muNextJob{0}, muJobsLeft{0}, mbQuit{false}
+{
+    mvWorkers.reserve(uNumWorkers);
+    for (u32 uWorker = 0; uNumWorkers > uWorker; ++uWorker)
+    {
+        mvWorkers.push_back(std::thread(&CWorkerPool::WorkerLoop, this));
+    }
+}
+
+CWorkerPool::~CWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lGuard(mLock);
+        mbQuit = true;
+    }
+    mWorkReady.notify_all();
+
+    for (std::vector<std::thread>::iterator pWorkIter = mvWorkers.begin(); pWorkIter != mvWorkers.end(); ++pWorkIter) { pWorkIter->join(); }
+}
+
+/*!
+ * \brief CWorkerPool::Run
+ *
+ * This method runs jobs [0 - uNumJobs) of a batch, on the workers and on the calling thread, and returns once every one of them has finished.
+ *
+ * \param uNumJobs - Number of jobs.
+ * \param fJob - Runs one job, it's given the job's number.
+ */
+void CWorkerPool::Run(u32 uNumJobs, const std::function<void(u32)>& fJob)
+{
+    if (0 == uNumJobs) { return; }
+
+    std::unique_lock<std::mutex> lLock(mLock);
+    mpJob = &fJob;
+    muNumJobs = uNumJobs;
+    muNextJob = 0;
+    muJobsLeft = uNumJobs;
+    mWorkReady.notify_all();
+
+    // Pitch in rather than sit idle, then wait for whatever the workers still have.
+    while (RunNextJob(lLock)) {}
+    mWorkDone.wait(lLock, [this]() { return 0 == muJobsLeft; });
+
+    mpJob = nullptr;
+    muNumJobs = 0;
+}
+
+u32 CWorkerPool::GetNumWorkers()
+{
+    return static_cast<u32>(mvWorkers.size());
+}
+
+/*!
+ * \brief CWorkerPool::WorkerLoop
+ *
+ * This is the body of every worker: sleep until a batch has jobs nobody has taken, run them, repeat until the pool shuts down.
+ */
+void CWorkerPool::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lLock(mLock);
+    while (!mbQuit)
+    {
+        if (!RunNextJob(lLock))
+        {
+            mWorkReady.wait(lLock, [this]() { return mbQuit || (nullptr != mpJob && muNumJobs > muNextJob); });
+        }
+    }
+}
+
+/*!
+ * \brief CWorkerPool::RunNextJob
+ *
+ * This function takes the next job of the current batch and runs it with the lock released.
+ *
+ * \param lLock - Held lock on mLock, it's held again on return.
+ * \return True if a job was run, false if the batch has no jobs left to take.
+ */
+bool CWorkerPool::RunNextJob(std::unique_lock<std::mutex>& lLock)
+{
+    if (nullptr == mpJob || muNumJobs <= muNextJob) { return false; }
+
+    const u32 c_uJob = muNextJob++;
+    const std::function<void(u32)>* pJob = mpJob;
+
+    lLock.unlock();
+    (*pJob)(c_uJob);
+    lLock.lock();
+
+    if (0 == --muJobsLeft) { mWorkDone.notify_all(); }
+
+    return true;
+}